@@ -21,6 +21,7 @@
 
 #pragma once
 #include <Types.hpp>
+#include <fs/fs_Hash.hpp>
 
 namespace cfg
 {
@@ -44,6 +45,9 @@ namespace cfg
         SET_OPTIONAL_VALUE(u32, menu_item_size)
 
         bool ignore_required_fw_ver;
+        bool verify_install_hashes;
+        bool natural_sort;
+        fs::HashType copy_verify;
         std::vector<WebBookmark> bookmarks;
 
         void Save();
@@ -44,6 +44,10 @@ namespace err
         R_DEFINE(Goldleaf, CouldNotBuildNSP, 7)
         R_DEFINE(Goldleaf, KeyGenMismatch, 8)
         R_DEFINE(Goldleaf, InvalidNSP, 9)
+        R_DEFINE(Goldleaf, CopyVerificationFailed, 10)
+        R_DEFINE(Goldleaf, CopyInterrupted, 11)
+        R_DEFINE(Goldleaf, ContentNotFound, 12)
+        R_DEFINE(Goldleaf, ContentHashMismatch, 13)
 
         static inline Result MakeErrnoResult()
         {
@@ -0,0 +1,67 @@
+
+/*
+
+    Goldleaf - Multipurpose homebrew tool for Nintendo Switch
+    Copyright (C) 2018-2019  XorTroll
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+#pragma once
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#include <Types.hpp>
+
+namespace fs
+{
+    static constexpr u32 BlockRingDefaultSlotCount = 4;
+
+    // A filled slot, tagged with what it holds so that a single producer can feed several destinations
+    struct RingBlock
+    {
+        u8 *Data;
+        u32 Tag;
+        u64 Offset;
+        u64 Size;
+    };
+
+    // Bounded ring of (0x1000-aligned) slots carved from one buffer, between a producer thread and a consumer.
+    // Either side can end it: the producer with Finish once everything was pushed, the consumer with Cancel on errors.
+    class BlockRing
+    {
+        public:
+            BlockRing(u8 *Buffer, u64 BufferSize, u32 SlotCount = BlockRingDefaultSlotCount);
+            u64 GetSlotSize();
+            u8 *AcquireFree();
+            void Push(RingBlock Block);
+            bool Pop(RingBlock &Out);
+            void Release(u8 *Data);
+            void Finish();
+            void Cancel();
+            bool IsCancelled();
+        private:
+            std::mutex lock;
+            std::condition_variable freecv;
+            std::condition_variable readycv;
+            std::vector<u8*> freeslots;
+            std::deque<RingBlock> ready;
+            u64 slotsize;
+            bool finished;
+            bool cancelled;
+    };
+}
@@ -25,6 +25,8 @@
 #include <functional>
 #include <switch.h>
 #include <Types.hpp>
+#include <fs/fs_Hash.hpp>
+#include <fs/fs_Path.hpp>
 
 namespace fs
 {
@@ -42,24 +44,26 @@ namespace fs
 
     static constexpr u64 Size4GB = 0x100000000;
 
-    bool Exists(String Path);
-    bool IsFile(String Path);
-    bool IsDirectory(String Path);
-    void CreateFile(String Path);
-    void CreateConcatenationFile(String Path);
-    void CreateDirectory(String Path);
-    void CopyFile(String Path, String NewPath);
-    void CopyFileProgress(String Path, String NewPath, std::function<void(double Done, double Total)> Callback);
-    void CopyDirectory(String Dir, String NewDir);
-    void CopyDirectoryProgress(String Dir, String NewDir, std::function<void(double Done, double Total)> Callback);
-    void DeleteFile(String Path);
-    void DeleteDirectory(String Path);
-    void RenameFile(String Old, String New);
-    void RenameDirectory(String Old, String New);
-    bool IsFileBinary(String Path);
-    void WriteFile(String Path, std::vector<u8> Data);
-    u64 GetFileSize(String Path);
-    u64 GetDirectorySize(String Path);
+    bool Exists(const Utf8Path &Path);
+    bool IsFile(const Utf8Path &Path);
+    bool IsDirectory(const Utf8Path &Path);
+    void CreateFile(const Utf8Path &Path);
+    void CreateConcatenationFile(const Utf8Path &Path);
+    void CreateDirectory(const Utf8Path &Path);
+    void CopyFile(const Utf8Path &Path, const Utf8Path &NewPath);
+    Result CopyFileProgress(const Utf8Path &Path, const Utf8Path &NewPath, std::function<void(double Done, double Total)> Callback, HashType Verify = HashType::None);
+    void CopyDirectory(const Utf8Path &Dir, const Utf8Path &NewDir);
+    Result CopyDirectoryProgress(const Utf8Path &Dir, const Utf8Path &NewDir, std::function<void(double Done, double Total)> Callback, HashType Verify = HashType::None);
+    Result MoveFileProgress(const Utf8Path &Path, const Utf8Path &NewPath, std::function<void(double Done, double Total)> Callback, HashType Verify = HashType::None);
+    Result MoveDirectoryProgress(const Utf8Path &Dir, const Utf8Path &NewDir, std::function<void(double Done, double Total)> Callback, HashType Verify = HashType::None);
+    void DeleteFile(const Utf8Path &Path);
+    void DeleteDirectory(const Utf8Path &Path);
+    Result RenameFile(const Utf8Path &Old, const Utf8Path &New);
+    Result RenameDirectory(const Utf8Path &Old, const Utf8Path &New);
+    bool IsFileBinary(const Utf8Path &Path);
+    void WriteFile(const Utf8Path &Path, std::vector<u8> Data);
+    u64 GetFileSize(const Utf8Path &Path);
+    u64 GetDirectorySize(const Utf8Path &Path);
     String GetFileName(String Path);
     String GetBaseDirectory(String Path);
     String GetExtension(String Path);
@@ -0,0 +1,59 @@
+
+/*
+
+    Goldleaf - Multipurpose homebrew tool for Nintendo Switch
+    Copyright (C) 2018-2019  XorTroll
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+#pragma once
+#include <functional>
+#include <vector>
+#include <fs/fs_Explorer.hpp>
+
+namespace fs
+{
+    // Read from both ends of same-sized files before comparing them whole
+    static constexpr u64 DedupPartialSize = 0x10000;
+    static constexpr u64 DedupChunkSize = 0x100000;
+
+    enum class DedupStage
+    {
+        Listing,
+        Partial,
+        Full,
+    };
+
+    struct DuplicateGroup
+    {
+        u64 Size;
+        std::vector<u8> Hash;
+        std::vector<String> Paths;
+    };
+
+    struct DedupReport
+    {
+        std::vector<DuplicateGroup> Groups;
+        u32 FileCount;
+        u64 ReclaimableSize;
+    };
+
+    DedupReport FindDuplicates(Explorer *Exp, String Dir, std::function<void(DedupStage Stage, double Done, double Total)> Callback);
+    u64 DeleteDuplicates(Explorer *Exp, const DedupReport &Report);
+    void SaveDedupReport(const DedupReport &Report);
+    String GetDedupReportPath();
+}
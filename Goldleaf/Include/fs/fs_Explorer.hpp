@@ -21,7 +21,16 @@
 
 #pragma once
 #include <vector>
+#include <unordered_map>
 #include <fs/fs_Common.hpp>
+#include <fs/fs_Hash.hpp>
+#include <fs/fs_Journal.hpp>
+#include <fs/fs_LineIndex.hpp>
+#include <fs/fs_HexView.hpp>
+#include <fs/fs_FileView.hpp>
+#include <fs/fs_Stats.hpp>
+#include <fs/fs_Path.hpp>
+#include <fs/fs_MountTable.hpp>
 
 namespace fs
 {
@@ -30,85 +39,96 @@ namespace fs
         Read = 1,
         Write,
         Append,
+        // Writes over an existing (preallocated) file from its start, without truncating it
+        Update,
     };
 
+    struct DirectoryEntry
+    {
+        String Name;
+        bool IsDirectory;
+    };
+
+    // Amount of entries fetched at once when listing a directory progressively
+    static constexpr u32 DirectoryBlockSize = 0x40;
+
+    // Prefix checked to tell binary files from text ones, 0x200 like GodMode9
+    static constexpr u64 BinaryCheckSize = 0x200;
+    static constexpr u32 BinaryCacheMaxEntries = 0x400;
+
     class Explorer
     {
         public:
+            virtual ~Explorer();
             virtual bool ShouldWarnOnWriteAccess();
+            virtual bool AllocateFile(const Utf8Path &Path, u64 Size);
+            virtual u64 GetModifiedTime(const Utf8Path &Path);
+            virtual void GetFileInfo(const Utf8Path &Path, u64 &Size, u64 &ModifiedTime);
             void SetNames(String MountName, String DisplayName);
             bool NavigateBack();
-            bool NavigateForward(String Path);
-            std::vector<String> GetContents();
+            bool NavigateForward(const Utf8Path &Path);
+            std::vector<String> GetContents(bool NaturalOrder = false);
             String GetMountName();
+            IoStats &GetStats();
             String GetCwd();
             String GetPresentableCwd();
-            inline String FullPathFor(String Path);
-            inline String FullPresentablePathFor(String Path);
-            inline String MakeFull(String Path);
-            inline bool IsFullPath(String Path);
-            void CopyFile(String Path, String NewPath);
-            void CopyFileProgress(String Path, String NewPath, std::function<void(double Done, double Total)> Callback);
-            void CopyDirectory(String Dir, String NewDir);
-            void CopyDirectoryProgress(String Dir, String NewDir, std::function<void(double Done, double Total)> Callback);
-            bool IsFileBinary(String Path);
-            std::vector<u8> ReadFile(String Path);
-            std::vector<String> ReadFileLines(String Path, u32 LineOffset, u32 LineCount);
-            std::vector<String> ReadFileFormatHex(String Path, u32 LineOffset, u32 LineCount);
-            u64 GetDirectorySize(String Path);
-            void DeleteDirectory(String Path);
-
-            virtual std::vector<String> GetDirectories(String Path) = 0;
-            virtual std::vector<String> GetFiles(String Path) = 0;
-            virtual bool Exists(String Path) = 0;
-            virtual bool IsFile(String Path) = 0;
-            virtual bool IsDirectory(String Path) = 0;
-            virtual void CreateFile(String Path) = 0;
-            virtual void CreateDirectory(String Path) = 0;
-            virtual void RenameFile(String Path, String NewName) = 0;
-            virtual void RenameDirectory(String Path, String NewName) = 0;
-            virtual void DeleteFile(String Path) = 0;
-            virtual void DeleteDirectorySingle(String Path) = 0;
+            String FullPathFor(String Path);
+            String FullPresentablePathFor(String Path);
+            Utf8Path MakeFullPath(const Utf8Path &Path);
+            void CopyFile(const Utf8Path &Path, const Utf8Path &NewPath);
+            Result CopyFileProgress(const Utf8Path &Path, const Utf8Path &NewPath, std::function<void(double Done, double Total)> Callback, HashType Verify = HashType::None, CopyJournal *Journal = NULL);
+            void CopyDirectory(const Utf8Path &Dir, const Utf8Path &NewDir);
+            Result CopyDirectoryProgress(const Utf8Path &Dir, const Utf8Path &NewDir, std::function<void(double Done, double Total)> Callback, HashType Verify = HashType::None, CopyJournal *Journal = NULL);
+            std::vector<u8> ComputeFileHash(const Utf8Path &Path, HashType Type);
+            bool IsFileBinary(const Utf8Path &Path);
+            std::vector<u8> ReadFile(const Utf8Path &Path);
+            FileView OpenView(const Utf8Path &Path);
+            std::vector<String> ReadFileLines(const Utf8Path &Path, u32 LineOffset, u32 LineCount);
+            std::vector<String> ReadFileFormatHex(const Utf8Path &Path, u32 LineOffset, u32 LineCount);
+            u64 GetDirectorySize(const Utf8Path &Path);
+            void DeleteDirectory(const Utf8Path &Path);
+
+            virtual std::vector<String> GetDirectories(const Utf8Path &Path) = 0;
+            virtual std::vector<String> GetFiles(const Utf8Path &Path) = 0;
+            virtual bool Exists(const Utf8Path &Path) = 0;
+            virtual bool IsFile(const Utf8Path &Path) = 0;
+            virtual bool IsDirectory(const Utf8Path &Path) = 0;
+            virtual void CreateFile(const Utf8Path &Path) = 0;
+            virtual void CreateDirectory(const Utf8Path &Path) = 0;
+            virtual Result RenameFile(const Utf8Path &Path, const Utf8Path &NewName) = 0;
+            virtual Result RenameDirectory(const Utf8Path &Path, const Utf8Path &NewName) = 0;
+            virtual void DeleteFile(const Utf8Path &Path) = 0;
+            virtual void DeleteDirectorySingle(const Utf8Path &Path) = 0;
             
-            virtual void StartFile(String path, FileMode mode) = 0;
-            virtual u64 ReadFileBlock(String Path, u64 Offset, u64 Size, u8 *Out) = 0;
-            virtual u64 WriteFileBlock(String Path, u8 *Data, u64 Size) = 0;
+            virtual void StartFile(const Utf8Path &path, FileMode mode) = 0;
+            virtual u64 ReadFileBlock(const Utf8Path &Path, u64 Offset, u64 Size, u8 *Out) = 0;
+            virtual u64 WriteFileBlock(const Utf8Path &Path, u8 *Data, u64 Size) = 0;
             virtual void EndFile(FileMode mode) = 0;
 
-            virtual u64 GetFileSize(String Path) = 0;
+            virtual void StartDirectory(const Utf8Path &Path) = 0;
+            virtual u32 ReadDirectoryBlock(u32 Count, std::vector<DirectoryEntry> &Out) = 0;
+            virtual void EndDirectory() = 0;
+
+            virtual u64 GetFileSize(const Utf8Path &Path) = 0;
             virtual u64 GetTotalSpace() = 0;
             virtual u64 GetFreeSpace() = 0;
-            virtual void SetArchiveBit(String Path) = 0;
+            virtual void SetArchiveBit(const Utf8Path &Path) = 0;
         protected:
             String dspname;
             String mntname;
-            String ecwd;
+            // Kept in UTF-8, so that full paths are built without going through String
+            std::string mntroot;
+            std::string ecwd;
+            std::unordered_map<std::string, std::pair<u64, bool>> bincache;
+            IoStats stats;
     };
 
-    String Explorer::FullPathFor(String Path)
-    {
-        String fpath = this->ecwd;
-        if(this->ecwd.substr(this->ecwd.length() - 1) != "/") fpath += "/";
-        fpath += Path;
-        return fpath;
-    }
-
-    String Explorer::FullPresentablePathFor(String Path)
-    {
-        String pcwd = this->GetPresentableCwd();
-        String fpath = pcwd;
-        if(pcwd.substr(pcwd.length() - 1) != "/") fpath += "/";
-        fpath += Path;
-        return fpath;
-    }
-
-    String Explorer::MakeFull(String Path)
-    {
-        return (this->IsFullPath(Path) ? Path : this->FullPathFor(Path));
-    }
+    bool IsBinaryData(const u8 *Data, u64 Size);
+    void SortNames(std::vector<String> &Names, bool NaturalOrder = false);
+    void SortDirectoryEntries(std::vector<DirectoryEntry>::iterator Begin, std::vector<DirectoryEntry>::iterator End, bool NaturalOrder = false);
 
-    bool Explorer::IsFullPath(String Path)
+    inline bool IsFullPath(std::string_view Path)
     {
-        return (Path.find(":/") != String::npos);
+        return (Path.find(":/") != std::string_view::npos);
     }
 }
\ No newline at end of file
@@ -23,6 +23,11 @@
 #include <fs/fs_Common.hpp>
 #include <fs/fs_Explorer.hpp>
 #include <fs/fs_FspExplorers.hpp>
+#include <fs/fs_RamExplorer.hpp>
+#include <fs/fs_Hash.hpp>
+#include <fs/fs_BlockRing.hpp>
+#include <fs/fs_Dedup.hpp>
+#include <fs/fs_Index.hpp>
 #include <fs/fs_RemotePCExplorer.hpp>
 #include <fs/fs_StdExplorer.hpp>
 
@@ -34,6 +39,8 @@ namespace fs
     NANDExplorer *GetNANDUserExplorer();
     NANDExplorer *GetNANDSystemExplorer();
     RemotePCExplorer *GetRemotePCExplorer(String MountName);
+    RamExplorer *GetRamExplorer();
     Explorer *GetExplorerForMountName(String MountName);
-    Explorer *GetExplorerForPath(String Path);
+    Explorer *GetExplorerForPath(const Utf8Path &Path);
+    std::vector<Explorer*> GetLoadedExplorers();
 }
\ No newline at end of file
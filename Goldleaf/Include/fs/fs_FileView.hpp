@@ -0,0 +1,62 @@
+
+/*
+
+    Goldleaf - Multipurpose homebrew tool for Nintendo Switch
+    Copyright (C) 2018-2019  XorTroll
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+#pragma once
+#include <fs/fs_Common.hpp>
+
+namespace fs
+{
+    class Explorer;
+
+    static constexpr u64 FileViewPageSize = 0x4000;
+    static constexpr u32 FileViewMaxPages = 8;
+
+    // Read-only view of a file, pages are only read when something inside them is requested.
+    // Returned pointers stay valid until the next Get call on the same view.
+    class FileView
+    {
+        public:
+            FileView(Explorer *Exp, const Utf8Path &Path);
+            u64 GetSize();
+            const u8 *Get(u64 Offset, u64 Size);
+
+            template<typename T>
+            const T *GetAs(u64 Offset)
+            {
+                return (const T*)this->Get(Offset, sizeof(T));
+            }
+        private:
+            struct Page
+            {
+                u64 Index;
+                u64 LastUse;
+                std::vector<u8> Data;
+            };
+
+            Page *GetPage(u64 Index);
+            Explorer *exp;
+            Utf8Path path;
+            u64 fsize;
+            u64 usecount;
+            std::vector<Page> pages;
+            std::vector<u8> span;
+    };
+}
@@ -0,0 +1,53 @@
+
+/*
+
+    Goldleaf - Multipurpose homebrew tool for Nintendo Switch
+    Copyright (C) 2018-2019  XorTroll
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+#pragma once
+#include <vector>
+#include <switch.h>
+#include <Types.hpp>
+
+namespace fs
+{
+    enum class HashType
+    {
+        None,
+        SHA256,
+        CRC32C,
+    };
+
+    class Hasher
+    {
+        public:
+            Hasher(HashType Type);
+            HashType GetType();
+            void Update(const void *Data, size_t Size);
+            std::vector<u8> Finish();
+        private:
+            HashType type;
+            Sha256Context sha;
+            u32 crc;
+    };
+
+    String FormatHash(std::vector<u8> Hash);
+    void WriteHashManifest(String Path, HashType Type, std::vector<u8> Hash);
+    HashType StringToHashType(std::string Str);
+    std::string HashTypeToString(HashType Type);
+}
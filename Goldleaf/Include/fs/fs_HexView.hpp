@@ -0,0 +1,59 @@
+
+/*
+
+    Goldleaf - Multipurpose homebrew tool for Nintendo Switch
+    Copyright (C) 2018-2019  XorTroll
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+#pragma once
+#include <fs/fs_Common.hpp>
+
+namespace fs
+{
+    class Explorer;
+
+    static constexpr u32 HexLineBytes = 0x10;
+    // " OFFSET   XX XX ... XX  ASCII"
+    static constexpr u32 HexLineLength = 1 + 8 + 3 + (HexLineBytes * 3) + 2 + HexLineBytes;
+    static constexpr u64 HexPageSize = 0x10000;
+    static constexpr u32 HexPageCacheCount = 8;
+
+    class HexView
+    {
+        public:
+            HexView();
+            void Reset(Explorer *Exp, const Utf8Path &Path);
+            std::vector<String> ReadLines(u32 LineOffset, u32 LineCount);
+        private:
+            struct Page
+            {
+                u64 Offset;
+                u64 Size;
+                u64 LastUse;
+                std::vector<u8> Data;
+            };
+
+            Page &GetPage(u64 Offset);
+            Explorer *exp;
+            Utf8Path path;
+            u64 fsize;
+            u64 usecount;
+            std::vector<Page> pages;
+    };
+
+    void FormatHexLine(char *Out, u64 Offset, const u8 *Data, u32 Size);
+}
@@ -0,0 +1,140 @@
+
+/*
+
+    Goldleaf - Multipurpose homebrew tool for Nintendo Switch
+    Copyright (C) 2018-2019  XorTroll
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <fs/fs_Common.hpp>
+
+namespace fs
+{
+    // Upper bound on the indexed files, so that a huge PC drive can't eat all the memory
+    static constexpr u32 IndexMaxFiles = 0x40000;
+    // Work done between two checks for a pause or a stop request
+    static constexpr u64 IndexStepBudgetNs = 4000000;
+    static constexpr u32 IndexMagic = 0x49464C47; // "GLFI"
+    static constexpr u32 IndexVersion = 1;
+
+    struct IndexedFile
+    {
+        std::string Name;
+        u64 Size;
+        u64 ModifiedTime;
+    };
+
+    struct IndexedDirectory
+    {
+        u64 ModifiedTime;
+        u32 Pass;
+        std::vector<std::string> Directories;
+        std::vector<IndexedFile> Files;
+    };
+
+    struct IndexResult
+    {
+        String Path;
+        u64 Size;
+        u64 ModifiedTime;
+    };
+
+    // Persistent index of the files under a set of roots (full paths like "sdmc:/"), kept in UTF-8.
+    // It's loaded and walked on its own thread: a directory whose modification time didn't change since the last pass isn't listed again, only its subdirectories get checked.
+    // Searches use name trigrams (or a sorted name table for queries shorter than 3 characters), rebuilt on that thread once a pass finishes and then swapped in.
+    class FileIndex
+    {
+        public:
+            FileIndex();
+            ~FileIndex();
+            void AddRoot(String Root);
+            void Refresh();
+            bool IsIndexing();
+            void Pause();
+            void Resume();
+            void Stop();
+            u32 GetFileCount();
+            std::vector<IndexResult> Search(String Query, u32 MaxResults);
+        private:
+            struct SearchEntry
+            {
+                u32 Directory;
+                u32 NameOffset;
+                u32 NameLength;
+                u64 Size;
+                u64 ModifiedTime;
+            };
+
+            struct SearchTable
+            {
+                std::vector<std::string> Directories;
+                std::string Names;
+                std::string LowerNames;
+                std::vector<SearchEntry> Entries;
+                std::vector<u32> ByName;
+                std::unordered_map<u32, std::vector<u32>> Trigrams;
+            };
+
+            void WorkerMain();
+            bool GetRoot(u32 Index, std::string &Out);
+            void StartPass();
+            void StartRoot(const std::string &Root);
+            void VisitDirectory(const std::string &Path);
+            bool Step(u64 BudgetNs);
+            void FinishPass();
+            std::shared_ptr<SearchTable> BuildSearch();
+            bool Load();
+            bool Save();
+
+            // Guards the roots, the published search table and the worker state
+            std::mutex lock;
+            std::condition_variable wakecv;
+            std::condition_variable idlecv;
+            std::thread worker;
+            std::vector<std::string> roots;
+            std::shared_ptr<SearchTable> search;
+            u32 paused;
+            bool indexing;
+            bool restart;
+            bool busy;
+            bool stop;
+            // Only used by the worker
+            std::unordered_map<std::string, IndexedDirectory> dirs;
+            u32 pass;
+            u32 rootidx;
+            bool changed;
+            u32 filecount;
+            std::deque<std::string> queue;
+            // Directory being listed over several steps, with the files still waiting for their size
+            std::string curdir;
+            std::vector<std::string> curfiles;
+            u32 curfileidx;
+    };
+
+    FileIndex &GetFileIndex();
+    String GetFileIndexPath();
+}
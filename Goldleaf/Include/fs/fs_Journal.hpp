@@ -0,0 +1,63 @@
+
+/*
+
+    Goldleaf - Multipurpose homebrew tool for Nintendo Switch
+    Copyright (C) 2018-2019  XorTroll
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+#pragma once
+#include <fs/fs_Common.hpp>
+#include <fs/fs_Path.hpp>
+#include <unordered_set>
+
+namespace fs
+{
+    class Explorer;
+
+    // Bytes copied between two journal flushes
+    static constexpr u64 JournalFlushInterval = 0x4000000;
+    static constexpr u32 JournalFlushFileCount = 0x20;
+    // Amount of already copied data compared against the source before resuming a partial file
+    static constexpr u64 JournalTailCheckSize = 0x10000;
+
+    class CopyJournal
+    {
+        public:
+            CopyJournal(const Utf8Path &Source, const Utf8Path &Destination);
+            static bool CanResume(const Utf8Path &Source, const Utf8Path &Destination);
+            bool IsFileCompleted(const Utf8Path &Path);
+            u64 GetResumeOffset(Explorer *Exp, const Utf8Path &Path, Explorer *NewExp, const Utf8Path &NewPath);
+            void SetProgress(const Utf8Path &NewPath, u64 Offset);
+            void SetFileCompleted(const Utf8Path &NewPath);
+            bool IsPending();
+            void Flush();
+            void Finish();
+        private:
+            std::string src;
+            std::string dst;
+            std::vector<std::string> completed;
+            // Same paths as completed, which stays the serialized order, for constant-time lookups
+            std::unordered_set<std::string> completedset;
+            std::string curfile;
+            u64 curoffset;
+            u64 flushoffset;
+            u32 flushcount;
+    };
+
+    // Each destination gets its own journal, so that other copies can't replace or delete its checkpoint
+    String GetCopyJournalPath(const Utf8Path &Destination);
+}
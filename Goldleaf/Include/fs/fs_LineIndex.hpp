@@ -0,0 +1,58 @@
+
+/*
+
+    Goldleaf - Multipurpose homebrew tool for Nintendo Switch
+    Copyright (C) 2018-2019  XorTroll
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+#pragma once
+#include <fs/fs_Common.hpp>
+
+namespace fs
+{
+    class Explorer;
+
+    // Only every n-th line start is kept, a window read starts at the nearest one before it
+    static constexpr u32 LineIndexStride = 0x20;
+    static constexpr u64 LineIndexBlockSize = 0x40000;
+    // Background indexing reads smaller blocks, as many as fit in the time given to a frame
+    static constexpr u64 LineIndexStepBlockSize = 0x8000;
+    static constexpr u64 LineIndexStepBudgetNs = 4000000;
+    // Upper bound for a single window read, longer lines get cut
+    static constexpr u64 LineWindowMaxSize = 0x100000;
+
+    class LineIndex
+    {
+        public:
+            LineIndex();
+            void Reset(Explorer *Exp, const Utf8Path &Path);
+            bool IndexNextBlock(u64 BlockSize = LineIndexBlockSize);
+            bool Step(u64 BudgetNs = LineIndexStepBudgetNs);
+            void IndexUntil(u32 Line);
+            bool IsComplete();
+            u32 GetLineCount();
+            std::vector<String> ReadLines(u32 LineOffset, u32 LineCount);
+        private:
+            Explorer *exp;
+            Utf8Path path;
+            u64 fsize;
+            u64 scanoff;
+            u32 lines;
+            std::vector<u64> checkpoints;
+            std::vector<u8> block;
+    };
+}
@@ -0,0 +1,81 @@
+
+/*
+
+    Goldleaf - Multipurpose homebrew tool for Nintendo Switch
+    Copyright (C) 2018-2019  XorTroll
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fs/fs_Path.hpp>
+
+namespace fs
+{
+    class Explorer;
+
+    // Small ID a mount name gets interned to, 0 meaning no mount
+    typedef u32 MountId;
+
+    static constexpr MountId InvalidMountId = 0;
+    static constexpr u32 MaxMounts = 0x20;
+    static constexpr u32 MountNameMaxLength = 0x100;
+
+    // Registry of the mounted explorers.
+    // Names are interned into a fixed open-addressed table and never move, so lookups are lock-free and don't copy the path.
+    // Registering and unregistering (which only swap the explorer of a slot) are serialized, so dynamic mounts can come and go while workers keep resolving paths.
+    // A slot left without explorer gets reused for a new name; its sequence changes meanwhile, so lookups racing with that retry instead of matching a half-written name.
+    // Unregistering doesn't delete the explorer: its owner must not free it while a worker may still be using it.
+    class MountTable
+    {
+        public:
+            MountTable();
+            MountId Register(Explorer *Exp);
+            void Unregister(Explorer *Exp);
+            MountId Lookup(std::string_view MountName);
+            MountId LookupPath(std::string_view Path);
+            Explorer *Get(MountId Id);
+            Explorer *GetForMountName(std::string_view MountName);
+            Explorer *GetForPath(std::string_view Path);
+            std::vector<Explorer*> GetAll();
+        private:
+            struct Slot
+            {
+                std::atomic<bool> used;
+                // Odd while the name is being rewritten
+                std::atomic<u32> seq;
+                std::atomic<u32> namelen;
+                char name[MountNameMaxLength];
+                std::atomic<Explorer*> exp;
+            };
+
+            static bool HasName(Slot &Entry, std::string_view MountName, u32 &Sequence);
+            static void SetName(Slot &Entry, std::string_view MountName);
+            MountId Intern(std::string_view MountName);
+            MountId Find(std::string_view MountName, u32 &Sequence);
+            Explorer *Resolve(std::string_view MountName);
+
+            Slot slots[MaxMounts];
+            std::mutex lock;
+    };
+
+    MountTable &GetMountTable();
+}
@@ -0,0 +1,56 @@
+
+/*
+
+    Goldleaf - Multipurpose homebrew tool for Nintendo Switch
+    Copyright (C) 2018-2019  XorTroll
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+#pragma once
+#include <string>
+#include <string_view>
+#include <Types.hpp>
+
+namespace fs
+{
+    // Path kept in UTF-8 for the filesystem layer, so that it only gets converted from/to String at the UI boundary.
+    // Parts of it are returned as views into the same buffer, and joins only allocate once (or not at all with Append).
+    class Utf8Path
+    {
+        public:
+            Utf8Path();
+            Utf8Path(const char *Str);
+            Utf8Path(std::string Str);
+            Utf8Path(std::string_view Str);
+            Utf8Path(String Str);
+
+            const char *CStr() const;
+            const std::string &Str() const;
+            std::string_view View() const;
+            bool IsEmpty() const;
+            std::string_view GetRoot() const;
+            std::string_view GetWithoutRoot() const;
+            std::string_view GetFileName() const;
+            std::string_view GetBaseDirectory() const;
+            std::string_view GetExtension() const;
+            Utf8Path &Append(std::string_view Name);
+            Utf8Path Join(std::string_view Name) const;
+            void Reserve(size_t Size);
+            String ToString() const;
+        private:
+            std::string str;
+    };
+}
@@ -0,0 +1,73 @@
+
+/*
+
+    Goldleaf - Multipurpose homebrew tool for Nintendo Switch
+    Copyright (C) 2018-2019  XorTroll
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+#pragma once
+#include <map>
+#include <set>
+#include <fs/fs_Explorer.hpp>
+
+namespace fs
+{
+    static constexpr u64 RamExplorerDefaultMaxSize = 0x2000000;
+
+    // Explorer kept entirely in memory, meant for small temporary files which don't need to hit flash
+    class RamExplorer final : public Explorer
+    {
+        public:
+            RamExplorer(String MountName, String DisplayName, u64 MaxSize);
+            virtual std::vector<String> GetDirectories(const Utf8Path &Path) override;
+            virtual std::vector<String> GetFiles(const Utf8Path &Path) override;
+            virtual bool Exists(const Utf8Path &Path) override;
+            virtual bool IsFile(const Utf8Path &Path) override;
+            virtual bool IsDirectory(const Utf8Path &Path) override;
+            virtual void CreateFile(const Utf8Path &Path) override;
+            virtual bool AllocateFile(const Utf8Path &Path, u64 Size) override;
+            virtual void CreateDirectory(const Utf8Path &Path) override;
+            virtual Result RenameFile(const Utf8Path &Path, const Utf8Path &NewName) override;
+            virtual Result RenameDirectory(const Utf8Path &Path, const Utf8Path &NewName) override;
+            virtual void DeleteFile(const Utf8Path &Path) override;
+            virtual void DeleteDirectorySingle(const Utf8Path &Path) override;
+            virtual void StartFile(const Utf8Path &path, FileMode mode) override;
+            virtual u64 ReadFileBlock(const Utf8Path &Path, u64 Offset, u64 Size, u8 *Out) override;
+            virtual u64 WriteFileBlock(const Utf8Path &Path, u8 *Data, u64 Size) override;
+            virtual void EndFile(FileMode mode) override;
+            virtual void StartDirectory(const Utf8Path &Path) override;
+            virtual u32 ReadDirectoryBlock(u32 Count, std::vector<DirectoryEntry> &Out) override;
+            virtual void EndDirectory() override;
+            virtual u64 GetFileSize(const Utf8Path &Path) override;
+            virtual u64 GetTotalSpace() override;
+            virtual u64 GetFreeSpace() override;
+            virtual void SetArchiveBit(const Utf8Path &Path) override;
+        private:
+            std::string Normalize(const Utf8Path &Path);
+            std::vector<std::string> ListChildren(const std::string &Dir, bool Directories);
+            bool Resize(std::vector<u8> &Data, u64 Size);
+
+            u64 maxsize;
+            u64 usedsize;
+            std::map<std::string, std::vector<u8>> files;
+            std::set<std::string> dirs;
+            std::string w_path;
+            u64 w_off;
+            std::vector<DirectoryEntry> dir_ents;
+            u32 dir_idx;
+    };
+}
@@ -28,24 +28,32 @@ namespace fs
     {
         public:
             RemotePCExplorer(String MountName);
-            virtual std::vector<String> GetDirectories(String Path) override;
-            virtual std::vector<String> GetFiles(String Path) override;
-            virtual bool Exists(String Path) override;
-            virtual bool IsFile(String Path) override;
-            virtual bool IsDirectory(String Path) override;
-            virtual void CreateFile(String Path) override;
-            virtual void CreateDirectory(String Path) override;
-            virtual void RenameFile(String Path, String NewName) override;
-            virtual void RenameDirectory(String Path, String NewName) override;
-            virtual void DeleteFile(String Path) override;
-            virtual void DeleteDirectorySingle(String Path) override;
-            virtual void StartFile(String path, FileMode mode) override;
-            virtual u64 ReadFileBlock(String Path, u64 Offset, u64 Size, u8 *Out) override;
-            virtual u64 WriteFileBlock(String Path, u8 *Data, u64 Size) override;
+            virtual std::vector<String> GetDirectories(const Utf8Path &Path) override;
+            virtual std::vector<String> GetFiles(const Utf8Path &Path) override;
+            virtual bool Exists(const Utf8Path &Path) override;
+            virtual bool IsFile(const Utf8Path &Path) override;
+            virtual bool IsDirectory(const Utf8Path &Path) override;
+            virtual void CreateFile(const Utf8Path &Path) override;
+            virtual void CreateDirectory(const Utf8Path &Path) override;
+            virtual Result RenameFile(const Utf8Path &Path, const Utf8Path &NewName) override;
+            virtual Result RenameDirectory(const Utf8Path &Path, const Utf8Path &NewName) override;
+            virtual void DeleteFile(const Utf8Path &Path) override;
+            virtual void DeleteDirectorySingle(const Utf8Path &Path) override;
+            virtual void StartFile(const Utf8Path &path, FileMode mode) override;
+            virtual u64 ReadFileBlock(const Utf8Path &Path, u64 Offset, u64 Size, u8 *Out) override;
+            virtual u64 WriteFileBlock(const Utf8Path &Path, u8 *Data, u64 Size) override;
             virtual void EndFile(FileMode mode) override;
-            virtual u64 GetFileSize(String Path) override;
+            virtual void StartDirectory(const Utf8Path &Path) override;
+            virtual u32 ReadDirectoryBlock(u32 Count, std::vector<DirectoryEntry> &Out) override;
+            virtual void EndDirectory() override;
+            virtual u64 GetFileSize(const Utf8Path &Path) override;
             virtual u64 GetTotalSpace() override;
             virtual u64 GetFreeSpace() override;
-            virtual void SetArchiveBit(String Path) override;
+            virtual void SetArchiveBit(const Utf8Path &Path) override;
+        private:
+            String dir_path;
+            u32 dir_count;
+            u32 file_count;
+            u32 dir_idx;
     };
 }
\ No newline at end of file
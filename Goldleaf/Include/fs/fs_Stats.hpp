@@ -0,0 +1,68 @@
+
+/*
+
+    Goldleaf - Multipurpose homebrew tool for Nintendo Switch
+    Copyright (C) 2018-2019  XorTroll
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+#pragma once
+#include <atomic>
+#include <fs/fs_Common.hpp>
+
+namespace fs
+{
+    enum class IoOperation : u32
+    {
+        Read,
+        Write,
+        Stat,
+        List,
+
+        Count
+    };
+
+    // Bucket n holds operations which took between 2^(n-1) and 2^n microseconds, the last one everything slower
+    static constexpr u32 LatencyBucketCount = 28;
+
+    struct IoOperationStats
+    {
+        std::atomic<u64> Ops;
+        std::atomic<u64> Bytes;
+        std::atomic<u64> Errors;
+        std::atomic<u64> TotalMicros;
+        std::atomic<u64> Latency[LatencyBucketCount];
+    };
+
+    class IoStats
+    {
+        public:
+            IoStats();
+            void Record(IoOperation Op, u64 StartTick, u64 Bytes, bool Error);
+            u64 GetOps(IoOperation Op);
+            u64 GetBytes(IoOperation Op);
+            u64 GetErrors(IoOperation Op);
+            u64 GetTotalMicros(IoOperation Op);
+            std::vector<u64> GetLatencyHistogram(IoOperation Op);
+            void Reset();
+            JSON ToJSON();
+        private:
+            IoOperationStats ops[static_cast<u32>(IoOperation::Count)];
+    };
+
+    String IoOperationToString(IoOperation Op);
+    void SaveIoStats();
+}
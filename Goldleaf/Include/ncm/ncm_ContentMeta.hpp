@@ -36,6 +36,7 @@ namespace ncm
             ContentMetaHeader GetContentMetaHeader();
             NcmContentMetaKey GetContentMetaKey();
             std::vector<ContentRecord> GetContentRecords();
+            std::vector<HashedContentRecord> GetHashedContentRecords();
             void GetInstallContentMeta(ByteBuffer &CNMTBuffer, ContentRecord &CNMTRecord, bool IgnoreVersion);
         private:
             ByteBuffer buf;
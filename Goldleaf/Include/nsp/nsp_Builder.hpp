@@ -23,8 +23,9 @@
 #include <string>
 #include <functional>
 #include <nsp/nsp_Types.hpp>
+#include <fs/fs_Hash.hpp>
 
 namespace nsp
 {
-    bool GenerateFrom(String Input, String Out, std::function<void(u64, u64)> Callback);
+    bool GenerateFrom(String Input, String Out, std::function<void(u64, u64)> Callback, fs::Hasher *Hash = NULL);
 }
\ No newline at end of file
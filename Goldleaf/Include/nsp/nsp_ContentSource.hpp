@@ -0,0 +1,66 @@
+
+/*
+
+    Goldleaf - Multipurpose homebrew tool for Nintendo Switch
+    Copyright (C) 2018-2019  XorTroll
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+#pragma once
+#include <optional>
+#include <unordered_map>
+#include <fs/fs_FileSystem.hpp>
+#include <nsp/nsp_Types.hpp>
+
+namespace nsp
+{
+    struct SourceFile
+    {
+        String Name;
+        // From the start of the file holding the container, not of its data
+        u64 Offset;
+        u64 Size;
+    };
+
+    // A flat container of files inside a bigger file (an NSP's PFS0, an XCI's secure HFS0...), which contents get installed from
+    class ContentSource
+    {
+        public:
+            ContentSource(fs::Explorer *Exp, String Path);
+            virtual ~ContentSource();
+            u32 GetCount();
+            String GetFile(u32 Index);
+            fs::Utf8Path GetPath();
+            u64 ReadFromFile(u32 Index, u64 Offset, u64 Size, u8 *Out);
+            std::vector<String> GetFiles();
+            bool IsOk();
+            fs::Explorer *GetExplorer();
+            u64 GetFileSize(u32 Index);
+            u64 GetFileOffset(u32 Index);
+            void SaveFile(u32 Index, fs::Explorer *Exp, String Path);
+            std::optional<u32> GetFileIndexByName(String File);
+        protected:
+            bool LoadPartition(u64 Offset, u32 PartitionMagic, u64 EntrySize);
+
+            fs::Utf8Path path;
+            fs::Explorer *gexp;
+            std::vector<SourceFile> files;
+            // Lowercased names, as lookups are case-insensitive
+            std::unordered_map<std::string, u32> nameidx;
+            bool ok;
+    };
+}
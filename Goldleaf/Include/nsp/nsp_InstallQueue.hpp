@@ -0,0 +1,63 @@
+
+/*
+
+    Goldleaf - Multipurpose homebrew tool for Nintendo Switch
+    Copyright (C) 2018-2019  XorTroll
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+#pragma once
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <nsp/nsp_Installer.hpp>
+
+namespace nsp
+{
+    // Packages prepared in the background while the current one writes its contents
+    static constexpr u32 InstallQueueLookahead = 2;
+
+    // Installs several NSPs back to back: while a package writes, the next ones get parsed and their metadata read ahead.
+    // The read ahead only happens between StartPrefetch and StopPrefetch, so it never overlaps NAND staging, tickets or finalization.
+    class InstallQueue
+    {
+        public:
+            InstallQueue(std::vector<String> Paths, fs::Explorer *Exp, Storage Location, u32 Lookahead = InstallQueueLookahead);
+            ~InstallQueue();
+            u32 GetCount();
+            String GetPath(u32 Index);
+            u64 GetPackageSize(u32 Index);
+            u64 GetTotalSize();
+            u64 GetSizeBefore(u32 Index);
+            std::unique_ptr<Installer> Take(u32 Index);
+            void StartPrefetch();
+            void StopPrefetch();
+        private:
+            void PrefetchMain();
+
+            std::vector<String> paths;
+            std::vector<u64> sizes;
+            fs::Explorer *exp;
+            Storage location;
+            u32 lookahead;
+            std::vector<std::unique_ptr<Installer>> insts;
+            u32 next;
+            u32 taken;
+            std::thread worker;
+            std::atomic<bool> stop;
+    };
+}
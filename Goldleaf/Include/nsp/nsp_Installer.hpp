@@ -26,6 +26,9 @@
 #include <memory>
 #include <Types.hpp>
 #include <nsp/nsp_PFS0.hpp>
+#include <nsp/nsp_XCI.hpp>
+#include <nsp/nsp_NCA.hpp>
+#include <nsp/nsp_NCZ.hpp>
 #include <ncm/ncm_ContentMeta.hpp>
 #include <es/es_Service.hpp>
 #include <ns/ns_Service.hpp>
@@ -35,11 +38,21 @@
 
 namespace nsp
 {
+    // Contents written at once, each with its own placeholder and a share of the ring slots
+    static constexpr u32 InstallMaxConcurrentContents = 3;
+    static constexpr u32 InstallRingSlotCount = 8;
+    static constexpr u32 InstallProgressIntervalMs = 100;
+
+    // NSPs and XCIs, and NSZs and XCZs (the same with NCAs compressed into NCZs)
+    bool IsPackageExtension(String Ext);
+    std::unique_ptr<ContentSource> OpenPackage(fs::Explorer *Exp, String Path);
+
     class Installer
     {
         public:
             Installer(String Path, fs::Explorer *Exp, Storage Location);
             ~Installer();
+            Result Prefetch();
             Result PrepareInstallation();
             Result PreProcessContents();
             ncm::ContentMetaType GetContentMetaType();
@@ -53,7 +66,13 @@ namespace nsp
             Result WriteContents(std::function<void(ncm::ContentRecord Record, u32 Content, u32 ContentCount, double Done, double Total, u64 BytesSec)> OnContentWrite);
             void FinalizeInstallation();
         private:
-            PFS0 nspentry;
+            bool LoadMeta(u32 Index);
+            Result StageMeta(String CnmtNca, u32 Index);
+            bool LoadControl(u32 Index, String ControlNcaId);
+            void StageControl(u32 Index, String ControlNca, String ControlNcaId);
+            void ExportIcon();
+
+            std::unique_ptr<ContentSource> source;
             NacpStruct entrynacp;
             u8 keygen;
             hos::TicketData entrytik;
@@ -65,6 +84,17 @@ namespace nsp
             u64 stik;
             String tik;
             std::vector<ncm::ContentRecord> ncas;
+            std::vector<ncm::HashedContentRecord> hashedncas;
             String icon;
+            // Read by LoadControl (maybe on the read-ahead thread), written out by ExportIcon
+            std::vector<u8> icondata;
+            bool prefetched;
+            Result prefetchrc;
+            bool metaloaded;
+            bool controlloaded;
+            String cnmtnca;
+            u32 idxcnmtnca;
+            u64 scnmtnca;
+            u32 idxtik;
     };
 }
\ No newline at end of file
@@ -0,0 +1,80 @@
+
+/*
+
+    Goldleaf - Multipurpose homebrew tool for Nintendo Switch
+    Copyright (C) 2018-2019  XorTroll
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+#pragma once
+#include <vector>
+#include <nsp/nsp_ContentSource.hpp>
+
+namespace nsp
+{
+    static constexpr u32 NCAMagic = 0x3341434E; // "NCA3"
+    static constexpr u64 NCAHeaderSize = 0xC00;
+    static constexpr u64 NCAMediaUnitSize = 0x200;
+    // Upper bound for section files read into memory, metadata (cnmt, NACP, icons) is way smaller
+    static constexpr u64 NCAMaxReadFileSize = 0x1000000;
+
+    enum class NCAFsType : u8
+    {
+        RomFs,
+        PFS0,
+    };
+
+    enum class NCAEncryptionType : u8
+    {
+        Auto,
+        None,
+        AesXts,
+        AesCtr,
+        AesCtrEx,
+    };
+
+    struct NCASectionFile
+    {
+        std::string Name;
+        u64 Offset;
+        u64 Size;
+    };
+
+    bool LoadKeys();
+
+    // Reads an NCA straight from inside its container, decrypting its header and sections in process.
+    // Only what metadata extraction needs is supported: NCA3, PFS0 and RomFS sections (root files only), plain or AES-CTR, and no titlekey crypto.
+    class NCA
+    {
+        public:
+            NCA(ContentSource &Source, u32 Index);
+            bool IsOk();
+            u8 GetKeyGeneration();
+            bool HasRightsId();
+            std::vector<NCASectionFile> ListSectionFiles(u32 Section);
+            std::vector<u8> ReadSectionFile(u32 Section, const NCASectionFile &File, u64 MaxSize = NCAMaxReadFileSize);
+        private:
+            bool ReadSection(u32 Section, u64 Offset, u64 Size, u8 *Out);
+
+            ContentSource &source;
+            u32 idx;
+            NCAHeader header;
+            NCAFsHeader fsheaders[4];
+            u8 ctrkey[0x10];
+            bool ok;
+    };
+}
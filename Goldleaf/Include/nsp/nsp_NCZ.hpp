@@ -0,0 +1,79 @@
+
+/*
+
+    Goldleaf - Multipurpose homebrew tool for Nintendo Switch
+    Copyright (C) 2018-2019  XorTroll
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+#pragma once
+#include <vector>
+#include <nsp/nsp_ContentSource.hpp>
+
+namespace nsp
+{
+    // NCZs keep the first 0x4000 bytes of the NCA as they are, then the rest decrypted and zstd-compressed
+    static constexpr u64 NCZHeaderOffset = 0x4000;
+    static constexpr u64 NCZSectionMagic = 0x4E544345535A434E; // "NCZSECTN"
+    static constexpr u64 NCZBlockMagic = 0x4B434F4C425A434E; // "NCZBLOCK"
+    static constexpr u64 NCZMaxSectionCount = 0x10;
+
+    struct NCZSection
+    {
+        u64 Offset;
+        u64 Size;
+        u64 CryptoType;
+        u64 Padding;
+        u8 CryptoKey[0x10];
+        u8 CryptoCounter[0x10];
+    } PACKED;
+
+    struct NCZBlockHeader
+    {
+        u64 Magic;
+        u8 Version;
+        u8 Type;
+        u8 Unused;
+        u8 BlockSizeExponent;
+        u32 BlockCount;
+        u64 DecompressedSize;
+    } PACKED;
+
+    // Headers of an NCZ inside an NSZ (or XCZ), and the re-encryption of its sections.
+    // The body is either one zstd stream (solid) or independent zstd blocks, which can be decompressed in parallel.
+    class NCZ
+    {
+        public:
+            NCZ(ContentSource &Source, u32 Index);
+            bool IsOk();
+            bool IsBlockCompressed();
+            u64 GetBlockSize();
+            u32 GetBlockCount();
+            u64 GetBlockOffset(u32 Block);
+            u64 GetCompressedBlockSize(u32 Block);
+            u64 GetDataOffset();
+            void Encrypt(u64 Offset, u8 *Data, u64 Size);
+        private:
+            std::vector<NCZSection> sections;
+            bool blocks;
+            u64 blocksize;
+            std::vector<u32> blocksizes;
+            std::vector<u64> blockoffs;
+            u64 dataoff;
+            bool ok;
+    };
+}
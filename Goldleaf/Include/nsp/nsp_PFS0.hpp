@@ -19,34 +19,15 @@
 
 */
 
+
 #pragma once
-#include <fs/fs_FileSystem.hpp>
-#include <nsp/nsp_Types.hpp>
+#include <nsp/nsp_ContentSource.hpp>
 
 namespace nsp
 {
-    class PFS0
+    class PFS0 : public ContentSource
     {
         public:
             PFS0(fs::Explorer *Exp, String Path);
-            ~PFS0();
-            u32 GetCount();
-            String GetFile(u32 Index);
-            String GetPath();
-            u64 ReadFromFile(u32 Index, u64 Offset, u64 Size, u8 *Out);
-            std::vector<String> GetFiles();
-            bool IsOk();
-            fs::Explorer *GetExplorer();
-            u64 GetFileSize(u32 Index);
-            void SaveFile(u32 Index, fs::Explorer *Exp, String Path);
-            u32 GetFileIndexByName(String File);
-        private:
-            String path;
-            fs::Explorer *gexp;
-            u8 *stringtable;
-            u32 headersize;
-            PFS0Header header;
-            std::vector<PFS0File> files;
-            bool ok;
     };
 }
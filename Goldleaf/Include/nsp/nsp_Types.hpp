@@ -46,5 +46,105 @@ namespace nsp
         String Name;
     };
 
+    struct HFS0FileEntry
+    {
+        u64 Offset;
+        u64 Size;
+        u32 StringTableOffset;
+        u32 HashedSize;
+        u64 Reserved;
+        u8 Hash[0x20];
+    } PACKED;
+
+    struct NCASectionEntry
+    {
+        u32 MediaStartOffset;
+        u32 MediaEndOffset;
+        u8 Unknown[8];
+    } PACKED;
+
+    struct NCAHeader
+    {
+        u8 FixedKeySignature[0x100];
+        u8 NPDMSignature[0x100];
+        u32 Magic;
+        u8 DistributionType;
+        u8 ContentType;
+        u8 KeyGenerationOld;
+        u8 KeyAreaEncryptionKeyIndex;
+        u64 ContentSize;
+        u64 ProgramId;
+        u32 ContentIndex;
+        u32 SDKAddonVersion;
+        u8 KeyGeneration;
+        u8 SignatureKeyGeneration;
+        u8 Reserved[0xE];
+        u8 RightsId[0x10];
+        NCASectionEntry SectionEntries[4];
+        u8 SectionHashes[4][0x20];
+        u8 EncryptedKeyArea[4][0x10];
+        u8 Padding[0xC0];
+    } PACKED;
+
+    struct NCAFsHeader
+    {
+        u16 Version;
+        u8 FsType;
+        u8 HashType;
+        u8 EncryptionType;
+        u8 Pad[3];
+        u8 HashInfo[0xF8];
+        u8 PatchInfo[0x40];
+        u8 SectionCtr[0x8];
+        u8 SparseInfo[0x30];
+        u8 Reserved[0x88];
+    } PACKED;
+
+    struct RomFsHeader
+    {
+        u64 HeaderSize;
+        u64 DirectoryHashTableOffset;
+        u64 DirectoryHashTableSize;
+        u64 DirectoryMetaTableOffset;
+        u64 DirectoryMetaTableSize;
+        u64 FileHashTableOffset;
+        u64 FileHashTableSize;
+        u64 FileMetaTableOffset;
+        u64 FileMetaTableSize;
+        u64 FileDataOffset;
+    } PACKED;
+
+    struct RomFsDirectoryEntry
+    {
+        u32 Parent;
+        u32 Sibling;
+        u32 ChildDirectory;
+        u32 ChildFile;
+        u32 Hash;
+        u32 NameLength;
+    } PACKED;
+
+    struct RomFsFileEntry
+    {
+        u32 Parent;
+        u32 Sibling;
+        u64 DataOffset;
+        u64 DataSize;
+        u32 Hash;
+        u32 NameLength;
+    } PACKED;
+
+    static_assert(sizeof(NCAHeader) == 0x400, "NCA header must be 0x400 bytes");
+    static_assert(sizeof(NCAFsHeader) == 0x200, "NCA section header must be 0x200 bytes");
+
     static constexpr u32 Magic = 0x30534650;
+    // First read of a PFS0, enough for the whole header of most NSPs
+    static constexpr u64 PFS0InitialReadSize = 0x4000;
+    static constexpr u64 PFS0MaxHeaderSize = 0x1000000;
+
+    static constexpr u32 HFS0Magic = 0x30534648; // "HFS0"
+    static constexpr u32 XCIMagic = 0x44414548; // "HEAD"
+    static constexpr u64 XCIMagicOffset = 0x100;
+    // Where the root HFS0's offset is stored, followed by its header size
+    static constexpr u64 XCIRootPartitionOffset = 0x130;
 }
\ No newline at end of file
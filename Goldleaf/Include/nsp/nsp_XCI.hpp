@@ -0,0 +1,37 @@
+
+/*
+
+    Goldleaf - Multipurpose homebrew tool for Nintendo Switch
+    Copyright (C) 2018-2019  XorTroll
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+#pragma once
+#include <memory>
+#include <nsp/nsp_ContentSource.hpp>
+
+namespace nsp
+{
+    class HFS0 : public ContentSource
+    {
+        public:
+            HFS0(fs::Explorer *Exp, String Path, u64 Offset);
+    };
+
+    // Gamecard dumps: contents get installed from the secure partition of the root HFS0
+    std::unique_ptr<ContentSource> OpenXCI(fs::Explorer *Exp, String Path);
+}
@@ -31,7 +31,8 @@ namespace ui
             CopyLayout();
             PU_SMART_CTOR(CopyLayout)
 
-            void StartCopy(String Path, String NewPath, bool Directory, fs::Explorer *Exp);
+            void StartCopy(String Path, String NewPath, bool Directory, fs::Explorer *Exp, bool Move = false);
+            fs::DedupReport ScanDuplicates(String Dir, fs::Explorer *Exp);
         private:
             fs::Explorer *gexp;
             pu::ui::elm::TextBlock::Ref infoText;
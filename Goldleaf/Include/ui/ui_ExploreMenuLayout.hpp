@@ -39,6 +39,7 @@ namespace ui
             void nandSafe_Click();
             void nandUser_Click();
             void nandSystem_Click();
+            void search_Click();
             void otherMount_Click();
             void specialMount_Click_X();
             void otherMount_Click_X();
@@ -51,6 +52,7 @@ namespace ui
             pu::ui::elm::MenuItem::Ref nandSafeMenuItem;
             pu::ui::elm::MenuItem::Ref nandUserMenuItem;
             pu::ui::elm::MenuItem::Ref nandSystemMenuItem;
+            pu::ui::elm::MenuItem::Ref searchMenuItem;
             std::vector<pu::ui::elm::MenuItem::Ref> mounts;
             std::vector<fs::Explorer*> expls;
     };
@@ -35,6 +35,7 @@ namespace ui
             void Update();
             void ScrollUp();
             void ScrollDown();
+            void UpdateIndex();
         private:
             u32 loffset;
             u32 rlines;
@@ -42,5 +43,7 @@ namespace ui
             String pth;
             pu::ui::elm::TextBlock::Ref cntText;
             fs::Explorer *gexp;
+            fs::LineIndex lindex;
+            fs::HexView hview;
     };
 }
\ No newline at end of file
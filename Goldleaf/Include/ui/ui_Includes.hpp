@@ -34,6 +34,7 @@
 #include <nfp/nfp_Emuiibo.hpp>
 #include <ns/ns_Service.hpp>
 #include <nsp/nsp_Installer.hpp>
+#include <nsp/nsp_InstallQueue.hpp>
 #include <nsp/nsp_Builder.hpp>
 #include <cfg/cfg_Strings.hpp>
 #include <ui/ui_Utils.hpp>
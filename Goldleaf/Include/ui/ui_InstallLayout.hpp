@@ -32,7 +32,10 @@ namespace ui
             PU_SMART_CTOR(InstallLayout)
 
             void StartInstall(String Path, fs::Explorer *Exp, Storage Location, bool OmitConfirmation = false);
+            void StartInstall(nsp::InstallQueue &Queue, u32 Index);
         private:
+            void DoInstall(nsp::Installer &Inst, bool OmitConfirmation, nsp::InstallQueue *Queue, u32 Index);
+
             pu::ui::elm::TextBlock::Ref installText;
             pu::ui::elm::ProgressBar::Ref installBar;
     };
@@ -34,6 +34,7 @@
 #include <ui/ui_MemoryLayout.hpp>
 #include <ui/ui_PartitionBrowserLayout.hpp>
 #include <ui/ui_PCExploreLayout.hpp>
+#include <ui/ui_SearchLayout.hpp>
 #include <ui/ui_SettingsLayout.hpp>
 #include <ui/ui_StorageContentsLayout.hpp>
 #include <ui/ui_UnusedTicketsLayout.hpp>
@@ -63,6 +64,7 @@ namespace ui
             void emuiibo_Input(u64 down, u64 up, u64 held);
             void exploreMenu_Input(u64 down, u64 up, u64 held);
             void pcExplore_Input(u64 down, u64 up, u64 held);
+            void search_Input(u64 down, u64 up, u64 held);
             void fileContent_Input(u64 down, u64 up, u64 held);
             void contentInformation_Input(u64 down, u64 up, u64 held);
             void storageContents_Input(u64 down, u64 up, u64 held);
@@ -85,6 +87,7 @@ namespace ui
             EmuiiboLayout::Ref &GetEmuiiboLayout();
             ExploreMenuLayout::Ref &GetExploreMenuLayout();
             PCExploreLayout::Ref &GetPCExploreLayout();
+            SearchLayout::Ref &GetSearchLayout();
             InstallLayout::Ref &GetInstallLayout();
             ContentInformationLayout::Ref &GetContentInformationLayout();
             StorageContentsLayout::Ref &GetStorageContentsLayout();
@@ -114,6 +117,7 @@ namespace ui
             EmuiiboLayout::Ref emuiibo;
             ExploreMenuLayout::Ref exploreMenu;
             PCExploreLayout::Ref pcExplore;
+            SearchLayout::Ref search;
             InstallLayout::Ref nspInstall;
             ContentInformationLayout::Ref contentInformation;
             StorageContentsLayout::Ref storageContents;
@@ -34,7 +34,9 @@ namespace ui
             void ChangePartitionSdCard(bool Update = true);
             void ChangePartitionNAND(fs::Partition Partition, bool Update = true);
             void ChangePartitionPCDrive(String Mount, bool Update = true);
+            void ChangePartitionExplorer(fs::Explorer *Exp, bool Update = true);
             void UpdateElements(int Idx = 0);
+            void UpdateVisibleElements();
             void HandleFileDirectly(String Path);
             bool GoBack();
             bool WarnNANDWriteAccess();
@@ -42,8 +44,15 @@ namespace ui
             void fsItems_Click_Y(String item);
             fs::Explorer *GetExplorer();
         private:
+            bool LoadElements(u64 BudgetNs);
+            void ShowElements(u32 Count);
+
             fs::Explorer *gexp;
-            std::vector<String> elems;
+            // Entries are listed over several frames and only get shown once sorted: in batches while scrolling, then all together once the listing is done
+            std::vector<fs::DirectoryEntry> elems;
+            bool elemsdone;
+            u32 elemssorted;
+            u32 elemsshown;
             pu::ui::elm::Menu::Ref browseMenu;
             pu::ui::elm::TextBlock::Ref dirEmptyText;
     };
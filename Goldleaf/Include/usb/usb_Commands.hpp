@@ -20,6 +20,7 @@
 */
 
 #pragma once
+#include <mutex>
 #include <Types.hpp>
 #include <usb/usb_Detail.hpp>
 
@@ -191,9 +192,13 @@ namespace usb
             size_t sz;
     };
 
+    // Commands can be issued from several threads (installs read ahead), but their blocks must not interleave
+    std::recursive_mutex &GetCommandLock();
+
     template<CommandId id, typename ...Args>
     Result ProcessCommand(Args &&...args)
     {
+        std::lock_guard<std::recursive_mutex> lk(GetCommandLock());
         InCommandBlock block(id);
         (args.ProcessIn(block), ...);
         auto rc = block.Send();
@@ -220,6 +220,9 @@ Result Initialize()
 
 void Exit()
 {
+    // The index walks the explorers from its own thread, so it must be done before they get deleted
+    fs::GetFileIndex().Stop();
+
     // If Goldleaf updated itself in this session...
     if(gupdated)
     {
@@ -228,6 +231,7 @@ void Exit()
         fs::RenameFile("sdmc:/" + consts::Root + "/update_tmp.nro", __system_argv[0]);
     }
 
+    fs::SaveIoStats();
     auto fsopsbuf = fs::GetFileSystemOperationsBuffer();
     operator delete[](fsopsbuf, std::align_val_t(0x1000));
     auto nsys = fs::GetNANDSystemExplorer();
@@ -235,11 +239,13 @@ void Exit()
     auto nusr = fs::GetNANDUserExplorer();
     auto prif = fs::GetPRODINFOFExplorer();
     auto sdcd = fs::GetSdCardExplorer();
+    auto ram = fs::GetRamExplorer();
     delete nsys;
     delete nsfe;
     delete nusr;
     delete prif;
     delete sdcd;
+    delete ram;
 
     splExit();
     usb::detail::Exit();
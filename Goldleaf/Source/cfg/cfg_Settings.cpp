@@ -48,6 +48,9 @@ namespace cfg
         if(this->has_scrollbar_color) json["ui"]["scrollBar"] = ColorToHex(this->scrollbar_color);
         if(this->has_progressbar_color) json["ui"]["progressBar"] = ColorToHex(this->progressbar_color);
         json["installs"]["ignoreRequiredFwVersion"] = this->ignore_required_fw_ver;
+        json["installs"]["verifyHashes"] = this->verify_install_hashes;
+        json["browser"]["naturalSort"] = this->natural_sort;
+        json["copies"]["verify"] = fs::HashTypeToString(this->copy_verify);
         for(u32 i = 0; i < this->bookmarks.size(); i++)
         {
             auto bmk = this->bookmarks[i];
@@ -124,6 +127,9 @@ namespace cfg
 
         gset.menu_item_size = 80;
         gset.ignore_required_fw_ver = true;
+        gset.verify_install_hashes = false;
+        gset.natural_sort = false;
+        gset.copy_verify = fs::HashType::None;
 
         ColorSetId csid = ColorSetId_Light;
         setsysGetColorSetId(&csid);
@@ -204,6 +210,15 @@ namespace cfg
             if(settings.count("installs"))
             {
                 gset.ignore_required_fw_ver = settings["installs"].value("ignoreRequiredFwVersion", true);
+                gset.verify_install_hashes = settings["installs"].value("verifyHashes", false);
+            }
+            if(settings.count("browser"))
+            {
+                gset.natural_sort = settings["browser"].value("naturalSort", false);
+            }
+            if(settings.count("copies"))
+            {
+                gset.copy_verify = fs::StringToHashType(settings["copies"].value("verify", "none"));
             }
             if(settings.count("web"))
             {
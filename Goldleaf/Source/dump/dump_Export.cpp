@@ -35,7 +35,10 @@ namespace dump
         s64 ncasize = 0;
         ncmContentStorageGetSizeFromContentId(ncst, &ncasize, &NCAId);
         u64 szrem = ncasize;
-        FILE *f = fopen(Path.AsUTF8().c_str(), "wb");
+        fs::Utf8Path path(Path);
+        auto exp = fs::GetExplorerForPath(path);
+        auto wmode = exp->AllocateFile(path, ncasize) ? fs::FileMode::Update : fs::FileMode::Write;
+        exp->StartFile(path, wmode);
         s64 off = 0;
         u64 rmax = fs::GetFileSystemOperationsBufferSize();
         u8 *data = fs::GetFileSystemOperationsBuffer();
@@ -43,12 +46,12 @@ namespace dump
         {
             u64 rsize = std::min(rmax, szrem);
             if(ncmContentStorageReadContentIdFile(ncst, data, rsize, &NCAId, off) != 0) break;
-            fwrite(data, 1, rsize, f);
+            exp->WriteFileBlock(path, data, rsize);
             szrem -= rsize;
             off += rsize;
             Callback((double)off, (double)ncasize);
         }
-        fclose(f);
+        exp->EndFile(wmode);
     }
 
     bool GetMetaRecord(NcmContentMetaDatabase *metadb, u64 ApplicationId, NcmContentMetaKey *out)
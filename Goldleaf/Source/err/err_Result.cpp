@@ -57,6 +57,10 @@ namespace err
         { result::ResultCouldNotBuildNSP, 11 },
         { result::ResultKeyGenMismatch, 12 },
         { result::ResultInvalidNSP, 3 },
+        { result::ResultCopyVerificationFailed, 13 },
+        { result::ResultCopyInterrupted, 14 },
+        { result::ResultContentNotFound, 15 },
+        { result::ResultContentHashMismatch, 16 },
     };
 
     static std::map<u32, u32> ModuleStringTable =
@@ -0,0 +1,100 @@
+
+/*
+
+    Goldleaf - Multipurpose homebrew tool for Nintendo Switch
+    Copyright (C) 2018-2019  XorTroll
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+#include <fs/fs_BlockRing.hpp>
+
+namespace fs
+{
+    BlockRing::BlockRing(u8 *Buffer, u64 BufferSize, u32 SlotCount) : finished(false), cancelled(false)
+    {
+        this->slotsize = (BufferSize / SlotCount) & ~0xFFFul;
+        for(u32 i = 0; i < SlotCount; i++) this->freeslots.push_back(Buffer + (i * this->slotsize));
+    }
+
+    u64 BlockRing::GetSlotSize()
+    {
+        return this->slotsize;
+    }
+
+    u8 *BlockRing::AcquireFree()
+    {
+        std::unique_lock<std::mutex> lk(this->lock);
+        this->freecv.wait(lk, [&]() { return this->cancelled || !this->freeslots.empty(); });
+        if(this->cancelled) return NULL;
+        auto slot = this->freeslots.back();
+        this->freeslots.pop_back();
+        return slot;
+    }
+
+    void BlockRing::Push(RingBlock Block)
+    {
+        {
+            std::lock_guard<std::mutex> lk(this->lock);
+            this->ready.push_back(Block);
+        }
+        this->readycv.notify_one();
+    }
+
+    bool BlockRing::Pop(RingBlock &Out)
+    {
+        std::unique_lock<std::mutex> lk(this->lock);
+        this->readycv.wait(lk, [&]() { return this->cancelled || this->finished || !this->ready.empty(); });
+        if(this->cancelled || this->ready.empty()) return false;
+        Out = this->ready.front();
+        this->ready.pop_front();
+        return true;
+    }
+
+    void BlockRing::Release(u8 *Data)
+    {
+        {
+            std::lock_guard<std::mutex> lk(this->lock);
+            this->freeslots.push_back(Data);
+        }
+        this->freecv.notify_one();
+    }
+
+    void BlockRing::Finish()
+    {
+        {
+            std::lock_guard<std::mutex> lk(this->lock);
+            this->finished = true;
+        }
+        this->readycv.notify_all();
+    }
+
+    void BlockRing::Cancel()
+    {
+        {
+            std::lock_guard<std::mutex> lk(this->lock);
+            this->cancelled = true;
+        }
+        this->freecv.notify_all();
+        this->readycv.notify_all();
+    }
+
+    bool BlockRing::IsCancelled()
+    {
+        std::lock_guard<std::mutex> lk(this->lock);
+        return this->cancelled;
+    }
+}
@@ -20,6 +20,7 @@
 */
 
 #include <fs/fs_FileSystem.hpp>
+#include <err/err_Result.hpp>
 #include <fstream>
 #include <cstdlib>
 #include <cstdio>
@@ -39,45 +40,45 @@ namespace fs
     static u8 *opsbuf = NULL;
     static size_t opsbufsz = 0x800000;
 
-    bool Exists(String Path)
+    bool Exists(const Utf8Path &Path)
     {
         auto exp = GetExplorerForPath(Path);
         if(exp != NULL) return exp->Exists(Path);
         return false;
     }
 
-    bool IsFile(String Path)
+    bool IsFile(const Utf8Path &Path)
     {
         auto exp = GetExplorerForPath(Path);
         if(exp != NULL) return exp->IsFile(Path);
         return false;
     }
 
-    bool IsDirectory(String Path)
+    bool IsDirectory(const Utf8Path &Path)
     {
         auto exp = GetExplorerForPath(Path);
         if(exp != NULL) return exp->IsDirectory(Path);
         return false;
     }
 
-    void CreateFile(String Path)
+    void CreateFile(const Utf8Path &Path)
     {
         auto exp = GetExplorerForPath(Path);
         if(exp != NULL) exp->CreateFile(Path);
     }
 
-    void CreateConcatenationFile(String Path)
+    void CreateConcatenationFile(const Utf8Path &Path)
     {
-        fsdevCreateFile(Path.AsUTF8().c_str(), 0, FsCreateOption_BigFile);
+        fsdevCreateFile(Path.CStr(), 0, FsCreateOption_BigFile);
     }
 
-    void CreateDirectory(String Path)
+    void CreateDirectory(const Utf8Path &Path)
     {
         auto exp = GetExplorerForPath(Path);
         if(exp != NULL) exp->CreateDirectory(Path);
     }
 
-    void CopyFile(String Path, String NewPath)
+    void CopyFile(const Utf8Path &Path, const Utf8Path &NewPath)
     {
         Explorer *gexp = GetExplorerForPath(Path);
         Explorer *ogexp = GetExplorerForPath(NewPath);
@@ -86,83 +87,108 @@ namespace fs
         gexp->CopyFile(Path, NewPath);
     }
 
-    void CopyFileProgress(String Path, String NewPath, std::function<void(double Done, double Total)> Callback)
+    Result CopyFileProgress(const Utf8Path &Path, const Utf8Path &NewPath, std::function<void(double Done, double Total)> Callback, HashType Verify)
     {
         Explorer *gexp = GetExplorerForPath(Path);
-        Explorer *ogexp = GetExplorerForPath(NewPath);
-        auto fsize = gexp->GetFileSize(Path);
-        if((fsize >= Size4GB) && (ogexp == GetSdCardExplorer())) CreateConcatenationFile(NewPath);
-        gexp->CopyFileProgress(Path, NewPath, Callback);
+        CopyJournal journal(Path, NewPath);
+        auto rc = gexp->CopyFileProgress(Path, NewPath, Callback, Verify, &journal);
+        // Keep the journal of an interrupted copy, so that it can be resumed
+        if(R_SUCCEEDED(rc) && journal.IsPending()) return err::result::ResultCopyInterrupted;
+        journal.Finish();
+        return rc;
     }
 
-    void CopyDirectory(String Dir, String NewDir)
+    void CopyDirectory(const Utf8Path &Dir, const Utf8Path &NewDir)
     {
         Explorer *gexp = GetExplorerForPath(Dir);
         gexp->CopyDirectory(Dir, NewDir);
     }
 
-    void CopyDirectoryProgress(String Dir, String NewDir, std::function<void(double Done, double Total)> Callback)
+    Result CopyDirectoryProgress(const Utf8Path &Dir, const Utf8Path &NewDir, std::function<void(double Done, double Total)> Callback, HashType Verify)
     {
         Explorer *gexp = GetExplorerForPath(Dir);
-        gexp->CopyDirectoryProgress(Dir, NewDir, Callback);
+        CopyJournal journal(Dir, NewDir);
+        auto rc = gexp->CopyDirectoryProgress(Dir, NewDir, Callback, Verify, &journal);
+        if(R_SUCCEEDED(rc) && journal.IsPending()) return err::result::ResultCopyInterrupted;
+        journal.Finish();
+        return rc;
     }
 
-    void DeleteFile(String Path)
+    Result MoveFileProgress(const Utf8Path &Path, const Utf8Path &NewPath, std::function<void(double Done, double Total)> Callback, HashType Verify)
+    {
+        Explorer *gexp = GetExplorerForPath(Path);
+        Explorer *ogexp = GetExplorerForPath(NewPath);
+        // Within the same filesystem a move is just a rename, no data needs to be copied
+        if(gexp == ogexp)
+        {
+            // A rename never replaces the destination, and a partial copy left there is superseded by it
+            if(CopyJournal::CanResume(Path, NewPath))
+            {
+                CopyJournal(Path, NewPath).Finish();
+                gexp->DeleteFile(NewPath);
+            }
+            return gexp->RenameFile(Path, NewPath);
+        }
+        R_TRY(CopyFileProgress(Path, NewPath, Callback, Verify));
+        gexp->DeleteFile(Path);
+        return 0;
+    }
+
+    Result MoveDirectoryProgress(const Utf8Path &Dir, const Utf8Path &NewDir, std::function<void(double Done, double Total)> Callback, HashType Verify)
+    {
+        Explorer *gexp = GetExplorerForPath(Dir);
+        Explorer *ogexp = GetExplorerForPath(NewDir);
+        // Moving onto an existing directory merges both, which a rename can't do
+        if((gexp == ogexp) && !gexp->Exists(NewDir)) return gexp->RenameDirectory(Dir, NewDir);
+        R_TRY(CopyDirectoryProgress(Dir, NewDir, Callback, Verify));
+        gexp->DeleteDirectory(Dir);
+        return 0;
+    }
+
+    void DeleteFile(const Utf8Path &Path)
     {
         auto exp = GetExplorerForPath(Path);
         if(exp != NULL) exp->DeleteFile(Path);
     }
 
-    void DeleteDirectory(String Path)
+    void DeleteDirectory(const Utf8Path &Path)
     {
         auto exp = GetExplorerForPath(Path);
         if(exp != NULL) exp->DeleteDirectory(Path);
     }
 
-    void RenameFile(String Old, String New)
+    Result RenameFile(const Utf8Path &Old, const Utf8Path &New)
     {
         auto exp = GetExplorerForPath(Old);
-        if(exp != NULL) exp->RenameFile(Old, New);
+        if(exp != NULL) return exp->RenameFile(Old, New);
+        return 0;
     }
 
-    void RenameDirectory(String Old, String New)
+    Result RenameDirectory(const Utf8Path &Old, const Utf8Path &New)
     {
         auto exp = GetExplorerForPath(Old);
-        if(exp != NULL) exp->RenameDirectory(Old, New);
+        if(exp != NULL) return exp->RenameDirectory(Old, New);
+        return 0;
     }
 
-    bool IsFileBinary(String Path)
+    bool IsFileBinary(const Utf8Path &Path)
     {
-        if(GetFileSize(Path) == 0) return true;
-        bool bin = false;
-        FILE *f = fopen(Path.AsUTF8().c_str(), "r");
-        if(f)
-        {
-            int ch = 0;
-            while((ch = fgetc(f)) != EOF)
-            {
-                if(!isascii(ch) || (iscntrl(ch) && !isspace(ch)))
-                {
-                    bin = true;
-                    break;
-                }
-            }
-        }
-        fclose(f);
-        return bin;
+        auto exp = GetExplorerForPath(Path);
+        if(exp != NULL) return exp->IsFileBinary(Path);
+        return true;
     }
 
-    void WriteFile(String Path, std::vector<u8> Data)
+    void WriteFile(const Utf8Path &Path, std::vector<u8> Data)
     {
         auto exp = GetExplorerForPath(Path);
         exp->DeleteFile(Path);
         exp->WriteFileBlock(Path, Data.data(), Data.size());
     }
 
-    u64 GetFileSize(String Path)
+    u64 GetFileSize(const Utf8Path &Path)
     {
         u64 sz = 0;
-        FILE *f = fopen(Path.AsUTF8().c_str(), "rb");
+        FILE *f = fopen(Path.CStr(), "rb");
         if(f)
         {
             fseek(f, 0, SEEK_END);
@@ -173,10 +199,10 @@ namespace fs
         return sz;
     }
 
-    u64 GetDirectorySize(String Path)
+    u64 GetDirectorySize(const Utf8Path &Path)
     {
         u64 sz = 0;
-        DIR *d = opendir(Path.AsUTF8().c_str());
+        DIR *d = opendir(Path.CStr());
         if(d)
         {
             struct dirent *dent;
@@ -184,8 +210,7 @@ namespace fs
             {
                 dent = readdir(d);
                 if(dent == NULL) break;
-                String nd = dent->d_name;
-                String pd = Path + "/" + nd;
+                auto pd = Path.Join(dent->d_name);
                 if(fs::IsFile(pd)) sz += GetFileSize(pd);
                 else sz += GetDirectorySize(pd);
             }
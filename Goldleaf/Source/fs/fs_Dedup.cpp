@@ -0,0 +1,203 @@
+
+/*
+
+    Goldleaf - Multipurpose homebrew tool for Nintendo Switch
+    Copyright (C) 2018-2019  XorTroll
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+#include <fs/fs_Dedup.hpp>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <unordered_map>
+
+namespace fs
+{
+    struct DedupFile
+    {
+        Utf8Path Path;
+        Hasher Hash;
+    };
+
+    static void ListFilesBySize(Explorer *Exp, const Utf8Path &Dir, std::unordered_map<u64, std::vector<String>> &Out, u32 &Count, std::function<void(DedupStage Stage, double Done, double Total)> &Callback)
+    {
+        for(auto &file: Exp->GetFiles(Dir))
+        {
+            auto path = Dir.Join(file.AsUTF8());
+            u64 size = Exp->GetFileSize(path);
+            // Empty files are all alike, they aren't worth reporting
+            if(size == 0) continue;
+            Out[size].push_back(path.ToString());
+            Count++;
+        }
+        Callback(DedupStage::Listing, Count, 0);
+        for(auto &sub: Exp->GetDirectories(Dir)) ListFilesBySize(Exp, Dir.Join(sub.AsUTF8()), Out, Count, Callback);
+    }
+
+    static std::vector<u8> HashFileEnds(Explorer *Exp, const Utf8Path &Path, u64 Size, u8 *Buffer)
+    {
+        Hasher hash(HashType::SHA256);
+        u64 headsz = std::min(Size, DedupPartialSize);
+        u64 rsz = Exp->ReadFileBlock(Path, 0, headsz, Buffer);
+        hash.Update(Buffer, rsz);
+        // The tail starts past the head, so for small files both together are the whole file
+        u64 tailoff = std::max(headsz, Size - std::min(Size, DedupPartialSize));
+        if(tailoff < Size)
+        {
+            rsz = Exp->ReadFileBlock(Path, tailoff, Size - tailoff, Buffer);
+            hash.Update(Buffer, rsz);
+        }
+        return hash.Finish();
+    }
+
+    static void CompareFull(Explorer *Exp, u64 Size, std::vector<String> &Paths, std::vector<DuplicateGroup> &Out, u8 *Buffer, u64 BufferSize, double &Done, double Total, std::function<void(DedupStage Stage, double Done, double Total)> &Callback)
+    {
+        // All candidates are read in lockstep, and split as soon as one chunk differs, so files which diverge early stop being read
+        std::vector<DedupFile> files;
+        for(auto &path: Paths) files.push_back({ path, Hasher(HashType::SHA256) });
+        std::vector<std::vector<u32>> groups(1);
+        for(u32 i = 0; i < files.size(); i++) groups[0].push_back(i);
+        u64 chunksz = std::min(BufferSize, DedupChunkSize);
+        for(u64 off = 0; (off < Size) && !groups.empty(); off += chunksz)
+        {
+            u64 rsz = std::min(chunksz, Size - off);
+            std::vector<std::vector<u32>> nextgroups;
+            for(auto &group: groups)
+            {
+                std::map<u32, std::vector<u32>> split;
+                for(auto idx: group)
+                {
+                    auto &file = files[idx];
+                    u64 read = Exp->ReadFileBlock(file.Path, off, rsz, Buffer);
+                    file.Hash.Update(Buffer, read);
+                    // CRC32C is enough to split, the final SHA-256 decides
+                    Hasher crc(HashType::CRC32C);
+                    crc.Update(Buffer, read);
+                    auto crcval = crc.Finish();
+                    u32 key = 0;
+                    memcpy(&key, crcval.data(), std::min(crcval.size(), sizeof(key)));
+                    split[key].push_back(idx);
+                    Done += rsz;
+                }
+                for(auto &[key, sub]: split)
+                {
+                    if(sub.size() > 1) nextgroups.push_back(std::move(sub));
+                    else Done += (Size - off - rsz);
+                }
+            }
+            groups = std::move(nextgroups);
+            Callback(DedupStage::Full, Done, Total);
+        }
+        for(auto &group: groups)
+        {
+            std::map<std::vector<u8>, std::vector<String>> byhash;
+            for(auto idx: group) byhash[files[idx].Hash.Finish()].push_back(files[idx].Path.ToString());
+            for(auto &[hash, paths]: byhash)
+            {
+                if(paths.size() < 2) continue;
+                Out.push_back({ Size, hash, paths });
+            }
+        }
+    }
+
+    DedupReport FindDuplicates(Explorer *Exp, String Dir, std::function<void(DedupStage Stage, double Done, double Total)> Callback)
+    {
+        DedupReport report = {};
+        std::unordered_map<u64, std::vector<String>> bysize;
+        ListFilesBySize(Exp, Exp->MakeFullPath(Dir), bysize, report.FileCount, Callback);
+
+        u8 *buf = GetFileSystemOperationsBuffer();
+        u64 bufsz = GetFileSystemOperationsBufferSize();
+        u32 partialtotal = 0;
+        for(auto &[size, paths]: bysize) if(paths.size() > 1) partialtotal += paths.size();
+        u32 partialdone = 0;
+        std::vector<std::pair<u64, std::vector<String>>> candidates;
+        for(auto &[size, paths]: bysize)
+        {
+            if(paths.size() < 2) continue;
+            std::map<std::vector<u8>, std::vector<String>> byends;
+            for(auto &path: paths)
+            {
+                byends[HashFileEnds(Exp, path, size, buf)].push_back(path);
+                partialdone++;
+                Callback(DedupStage::Partial, partialdone, partialtotal);
+            }
+            for(auto &[hash, same]: byends)
+            {
+                if(same.size() < 2) continue;
+                // Both ends already covered the whole file
+                if(size <= (2 * DedupPartialSize)) report.Groups.push_back({ size, hash, same });
+                else candidates.push_back({ size, std::move(same) });
+            }
+        }
+
+        double fulltotal = 0;
+        for(auto &[size, paths]: candidates) fulltotal += (double)size * paths.size();
+        double fulldone = 0;
+        for(auto &[size, paths]: candidates) CompareFull(Exp, size, paths, report.Groups, buf, bufsz, fulldone, fulltotal, Callback);
+
+        for(auto &group: report.Groups)
+        {
+            SortNames(group.Paths);
+            report.ReclaimableSize += group.Size * (group.Paths.size() - 1);
+        }
+        return report;
+    }
+
+    u64 DeleteDuplicates(Explorer *Exp, const DedupReport &Report)
+    {
+        // The first file of every group (in name order) is the one kept
+        u64 freed = 0;
+        for(auto &group: Report.Groups)
+        {
+            for(u32 i = 1; i < group.Paths.size(); i++)
+            {
+                Exp->DeleteFile(group.Paths[i]);
+                freed += group.Size;
+            }
+        }
+        return freed;
+    }
+
+    void SaveDedupReport(const DedupReport &Report)
+    {
+        auto json = JSON::object();
+        json["files"] = Report.FileCount;
+        json["reclaimable"] = Report.ReclaimableSize;
+        json["groups"] = JSON::array();
+        for(auto &group: Report.Groups)
+        {
+            auto jgroup = JSON::object();
+            jgroup["size"] = group.Size;
+            jgroup["sha256"] = FormatHash(group.Hash).AsUTF8();
+            jgroup["paths"] = JSON::array();
+            for(auto &path: group.Paths) jgroup["paths"].push_back(path.AsUTF8());
+            json["groups"].push_back(jgroup);
+        }
+        std::ofstream ofs(GetDedupReportPath().AsUTF8());
+        ofs << std::setw(4) << json;
+        ofs.close();
+    }
+
+    String GetDedupReportPath()
+    {
+        return "sdmc:/" + consts::Root + "/duplicates.json";
+    }
+}
@@ -20,21 +20,108 @@
 */
 
 #include <fs/fs_FileSystem.hpp>
+#include <err/err_Result.hpp>
 #include <sys/stat.h>
 #include <dirent.h>
 #include <malloc.h>
 #include <fstream>
 #include <algorithm>
-#include <iomanip>
 #include <cctype>
+#ifdef __aarch64__
+#include <arm_neon.h>
+#endif
 
 namespace fs
 {
-    static bool InternalCaseCompare(String a, String b)
+    static std::string MakeCollationKey(const std::string &Name, bool IsDirectory, bool NaturalOrder)
     {
-        std::transform(a.begin(), a.end(), a.begin(), ::tolower);
-        std::transform(b.begin(), b.end(), b.begin(), ::tolower);
-        return (a.AsUTF16() < b.AsUTF16());
+        // Directories always go first, then names are compared case-insensitively byte by byte.
+        // With natural ordering, digit runs become '0' + length + digits, so "file2" sorts before "file10".
+        std::string key;
+        key.reserve(Name.length() + 2);
+        key += (IsDirectory ? '\0' : '\1');
+        for(u32 i = 0; i < Name.length(); i++)
+        {
+            u8 ch = (u8)Name[i];
+            if(NaturalOrder && isdigit(ch))
+            {
+                u32 start = i;
+                while((start < (Name.length() - 1)) && (Name[start] == '0') && isdigit((u8)Name[start + 1])) start++;
+                u32 end = start;
+                while((end < Name.length()) && isdigit((u8)Name[end])) end++;
+                key += '0';
+                key += (char)std::min(end - start, (u32)0xFF);
+                key.append(Name, start, end - start);
+                i = end - 1;
+            }
+            else if(ch < 0x80) key += (char)tolower(ch);
+            else key += (char)ch;
+        }
+        return key;
+    }
+
+    static std::vector<u32> GetCollationOrder(const std::vector<std::string> &Keys)
+    {
+        // Keys are built once per entry, so sorting only compares plain byte strings
+        std::vector<u32> idxs(Keys.size());
+        for(u32 i = 0; i < idxs.size(); i++) idxs[i] = i;
+        std::sort(idxs.begin(), idxs.end(), [&](u32 a, u32 b) -> bool
+        {
+            return (Keys[a] < Keys[b]);
+        });
+        return idxs;
+    }
+
+    bool IsBinaryData(const u8 *Data, u64 Size)
+    {
+        // Anything outside printable ASCII and whitespace (0x09-0x0D) makes it binary
+        u64 i = 0;
+        #ifdef __aarch64__
+        const uint8x16_t del = vdupq_n_u8(0x7F);
+        const uint8x16_t space = vdupq_n_u8(0x20);
+        const uint8x16_t wsmin = vdupq_n_u8(0x09);
+        const uint8x16_t wsmax = vdupq_n_u8(0x0D);
+        for(; (i + 16) <= Size; i += 16)
+        {
+            uint8x16_t v = vld1q_u8(Data + i);
+            uint8x16_t ws = vandq_u8(vcgeq_u8(v, wsmin), vcleq_u8(v, wsmax));
+            uint8x16_t bad = vorrq_u8(vcgeq_u8(v, del), vbicq_u8(vcltq_u8(v, space), ws));
+            if(vmaxvq_u8(bad) != 0) return true;
+        }
+        #endif
+        for(; i < Size; i++)
+        {
+            u8 ch = Data[i];
+            if((ch >= 0x7F) || ((ch < 0x20) && ((ch < 0x09) || (ch > 0x0D)))) return true;
+        }
+        return false;
+    }
+
+    void SortNames(std::vector<String> &Names, bool NaturalOrder)
+    {
+        if(Names.size() < 2) return;
+        std::vector<std::string> keys;
+        keys.reserve(Names.size());
+        for(auto &name: Names) keys.push_back(MakeCollationKey(name.AsUTF8(), false, NaturalOrder));
+        auto idxs = GetCollationOrder(keys);
+        std::vector<String> sorted;
+        sorted.reserve(Names.size());
+        for(auto idx: idxs) sorted.push_back(std::move(Names[idx]));
+        Names = std::move(sorted);
+    }
+
+    void SortDirectoryEntries(std::vector<DirectoryEntry>::iterator Begin, std::vector<DirectoryEntry>::iterator End, bool NaturalOrder)
+    {
+        u32 count = std::distance(Begin, End);
+        if(count < 2) return;
+        std::vector<std::string> keys;
+        keys.reserve(count);
+        for(auto it = Begin; it != End; it++) keys.push_back(MakeCollationKey(it->Name.AsUTF8(), it->IsDirectory, NaturalOrder));
+        auto idxs = GetCollationOrder(keys);
+        std::vector<DirectoryEntry> sorted;
+        sorted.reserve(count);
+        for(auto idx: idxs) sorted.push_back(std::move(*(Begin + idx)));
+        std::move(sorted.begin(), sorted.end(), Begin);
     }
 
     bool Explorer::ShouldWarnOnWriteAccess()
@@ -42,38 +129,62 @@ namespace fs
         return false;
     }
 
+    bool Explorer::AllocateFile(const Utf8Path &Path, u64 Size)
+    {
+        return false;
+    }
+
+    // 0 means unknown, as not every backend reports modification times
+    u64 Explorer::GetModifiedTime(const Utf8Path &Path)
+    {
+        return 0;
+    }
+
+    void Explorer::GetFileInfo(const Utf8Path &Path, u64 &Size, u64 &ModifiedTime)
+    {
+        Size = this->GetFileSize(Path);
+        ModifiedTime = this->GetModifiedTime(Path);
+    }
+
+    Explorer::~Explorer()
+    {
+        GetMountTable().Unregister(this);
+    }
+
     void Explorer::SetNames(String MountName, String DisplayName)
     {
         this->dspname = DisplayName;
         this->mntname = MountName;
-        this->ecwd = MountName + ":/";
+        this->mntroot = MountName.AsUTF8() + ":/";
+        this->ecwd = this->mntroot;
     }
 
     bool Explorer::NavigateBack()
     {
-        if(this->ecwd == (this->mntname + ":/")) return false;
-        String parent = this->ecwd.substr(0, this->ecwd.find_last_of("/\\"));
-        if(parent.substr(parent.length() - 1) == ":") parent += "/";
+        if(this->ecwd == this->mntroot) return false;
+        auto parent = this->ecwd.substr(0, this->ecwd.find_last_of("/\\"));
+        if(parent.back() == ':') parent += "/";
         this->ecwd = parent;
         return true;
     }
 
-    bool Explorer::NavigateForward(String Path)
+    bool Explorer::NavigateForward(const Utf8Path &Path)
     {
-        bool idir = this->IsDirectory(Path);
-        if(idir) this->ecwd = this->MakeFull(Path);
+        auto path = this->MakeFullPath(Path);
+        bool idir = this->IsDirectory(path);
+        if(idir) this->ecwd = path.Str();
         return idir;
     }
 
-    std::vector<String> Explorer::GetContents()
+    std::vector<String> Explorer::GetContents(bool NaturalOrder)
     {
         auto dirs = this->GetDirectories(this->ecwd);
         auto files = this->GetFiles(this->ecwd);
 
-        if(!dirs.empty()) std::sort(dirs.begin(), dirs.end(), InternalCaseCompare);
+        if(!dirs.empty()) SortNames(dirs, NaturalOrder);
         if(!files.empty())
         {
-            std::sort(files.begin(), files.end(), InternalCaseCompare);
+            SortNames(files, NaturalOrder);
             dirs.insert(dirs.end(), files.begin(), files.end());
         }
 
@@ -85,6 +196,21 @@ namespace fs
         return this->mntname;
     }
 
+    Utf8Path Explorer::MakeFullPath(const Utf8Path &Path)
+    {
+        if(IsFullPath(Path.View())) return Path;
+        Utf8Path fpath;
+        fpath.Reserve(this->ecwd.length() + 1 + Path.Str().length());
+        fpath.Append(this->ecwd);
+        fpath.Append(Path.View());
+        return fpath;
+    }
+
+    IoStats &Explorer::GetStats()
+    {
+        return this->stats;
+    }
+
     String Explorer::GetCwd()
     {
         return this->ecwd;
@@ -92,17 +218,28 @@ namespace fs
 
     String Explorer::GetPresentableCwd()
     {
-        if(this->ecwd == (this->mntname + ":/")) return this->dspname + ":/";
-        u32 mntrootsize = this->mntname.length() + 2;
-        String cwdnoroot = this->ecwd.substr(mntrootsize);
-        return this->dspname + ":/" + cwdnoroot;
+        return this->dspname + ":/" + String(this->ecwd.substr(this->mntroot.length()));
+    }
+
+    String Explorer::FullPathFor(String Path)
+    {
+        return Utf8Path(this->ecwd).Append(Path.AsUTF8()).ToString();
     }
 
-    void Explorer::CopyFile(String Path, String NewPath)
+    String Explorer::FullPresentablePathFor(String Path)
     {
-        String path = this->MakeFull(Path);
+        String pcwd = this->GetPresentableCwd();
+        String fpath = pcwd;
+        if(pcwd.substr(pcwd.length() - 1) != "/") fpath += "/";
+        fpath += Path;
+        return fpath;
+    }
+
+    void Explorer::CopyFile(const Utf8Path &Path, const Utf8Path &NewPath)
+    {
+        auto path = this->MakeFullPath(Path);
         auto ex = GetExplorerForPath(NewPath);
-        String npath = ex->MakeFull(NewPath);
+        auto npath = ex->MakeFullPath(NewPath);
         u64 fsize = this->GetFileSize(path);
         u64 rsize = GetFileSystemOperationsBufferSize();
         u8 *data = GetFileSystemOperationsBuffer();
@@ -115,96 +252,147 @@ namespace fs
             u64 rbytes = this->ReadFileBlock(path, off, std::min(szrem, rsize), data);
             szrem -= rbytes;
             off += rbytes;
-            ex->WriteFileBlock(NewPath, data, rbytes);
+            ex->WriteFileBlock(npath, data, rbytes);
         }
         this->EndFile(fs::FileMode::Read);
         ex->EndFile(fs::FileMode::Write);
     }
 
-    void Explorer::CopyFileProgress(String Path, String NewPath, std::function<void(double Done, double Total)> Callback)
+    Result Explorer::CopyFileProgress(const Utf8Path &Path, const Utf8Path &NewPath, std::function<void(double Done, double Total)> Callback, HashType Verify, CopyJournal *Journal)
     {
-        String path = this->MakeFull(Path);
+        auto path = this->MakeFullPath(Path);
         auto ex = GetExplorerForPath(NewPath);
-        String npath = ex->MakeFull(NewPath);
+        auto npath = ex->MakeFullPath(NewPath);
         u64 fsize = this->GetFileSize(path);
         u64 rsize = GetFileSystemOperationsBufferSize();
         u8 *data = GetFileSystemOperationsBuffer();
-        u64 szrem = fsize;
         u64 off = 0;
+        if(Journal != NULL) off = Journal->GetResumeOffset(this, path, ex, npath);
+        u64 szrem = fsize - off;
+        auto wmode = fs::FileMode::Append;
+        if(off == 0) wmode = ex->AllocateFile(npath, fsize) ? fs::FileMode::Update : fs::FileMode::Write;
+        Hasher srchash(Verify);
         this->StartFile(path, fs::FileMode::Read);
-        ex->StartFile(npath, fs::FileMode::Write);
+        // When resuming, the already copied part still needs to go through the hash
+        for(u64 hoff = 0; (Verify != HashType::None) && (hoff < off);)
+        {
+            u64 rbytes = this->ReadFileBlock(path, hoff, std::min(off - hoff, rsize), data);
+            if(rbytes == 0) break;
+            hoff += rbytes;
+            srchash.Update(data, rbytes);
+        }
+        ex->StartFile(npath, wmode);
         while(szrem)
         {
             u64 rbytes = this->ReadFileBlock(path, off, std::min(szrem, rsize), data);
+            if(rbytes == 0) break;
             szrem -= rbytes;
             off += rbytes;
+            srchash.Update(data, rbytes);
             ex->WriteFileBlock(npath, data, rbytes);
+            if(Journal != NULL) Journal->SetProgress(npath, off);
             Callback((double)off, (double)fsize);
         }
         this->EndFile(fs::FileMode::Read);
-        ex->EndFile(fs::FileMode::Write);
+        ex->EndFile(wmode);
+        if(szrem > 0)
+        {
+            // An interrupted copy keeps its checkpoint so that it can be resumed later, verifying it only makes sense once it's complete
+            if(Journal == NULL) return err::result::ResultCopyInterrupted;
+            Journal->Flush();
+            return 0;
+        }
+        // The source was hashed while being copied, so only the destination needs to be read back
+        if((Verify != HashType::None) && (srchash.Finish() != ex->ComputeFileHash(npath, Verify))) return err::result::ResultCopyVerificationFailed;
+        if(Journal != NULL) Journal->SetFileCompleted(npath);
+        return 0;
     }
 
-    void Explorer::CopyDirectory(String Dir, String NewDir)
+    void Explorer::CopyDirectory(const Utf8Path &Dir, const Utf8Path &NewDir)
     {
-        String dir = this->MakeFull(Dir);
+        auto dir = this->MakeFullPath(Dir);
         auto ex = GetExplorerForPath(NewDir);
-        String ndir = ex->MakeFull(NewDir);
+        auto ndir = ex->MakeFullPath(NewDir);
         ex->CreateDirectory(ndir);
         auto dirs = this->GetDirectories(dir);
         for(auto &qdir: dirs)
         {
-            String dfrom = dir + "/" + qdir;
-            String dto = ndir + "/" + qdir;
-            this->CopyDirectory(dfrom, dto);
+            auto name = qdir.AsUTF8();
+            this->CopyDirectory(dir.Join(name), ndir.Join(name));
         }
         auto files = this->GetFiles(dir);
         for(auto &qfile: files)
         {
-            String dfrom = dir + "/" + qfile;
-            String dto = ndir + "/" + qfile;
-            this->CopyFile(dfrom, dto);
+            auto name = qfile.AsUTF8();
+            this->CopyFile(dir.Join(name), ndir.Join(name));
         }
     }
 
-    void Explorer::CopyDirectoryProgress(String Dir, String NewDir, std::function<void(double Done, double Total)> Callback)
+    Result Explorer::CopyDirectoryProgress(const Utf8Path &Dir, const Utf8Path &NewDir, std::function<void(double Done, double Total)> Callback, HashType Verify, CopyJournal *Journal)
     {
-        String dir = this->MakeFull(Dir);
+        auto dir = this->MakeFullPath(Dir);
         auto ex = GetExplorerForPath(NewDir);
-        String ndir = ex->MakeFull(NewDir);
+        auto ndir = ex->MakeFullPath(NewDir);
         ex->CreateDirectory(ndir);
         auto files = this->GetFiles(dir);
-        for(auto &cfile: files) this->CopyFileProgress(dir + "/" + cfile, ndir + "/" + cfile, Callback);
+        for(auto &cfile: files)
+        {
+            auto name = cfile.AsUTF8();
+            auto nfile = ndir.Join(name);
+            if((Journal != NULL) && Journal->IsFileCompleted(nfile)) continue;
+            R_TRY(this->CopyFileProgress(dir.Join(name), nfile, Callback, Verify, Journal));
+            if((Journal != NULL) && Journal->IsPending()) return 0;
+        }
         auto dirs = this->GetDirectories(dir);
-        for(auto &cdir: dirs) this->CopyDirectoryProgress(dir + "/" + cdir, ndir + "/" + cdir, Callback);
+        for(auto &cdir: dirs)
+        {
+            auto name = cdir.AsUTF8();
+            R_TRY(this->CopyDirectoryProgress(dir.Join(name), ndir.Join(name), Callback, Verify, Journal));
+            if((Journal != NULL) && Journal->IsPending()) return 0;
+        }
+        return 0;
     }
 
-    bool Explorer::IsFileBinary(String Path)
+    std::vector<u8> Explorer::ComputeFileHash(const Utf8Path &Path, HashType Type)
     {
-        String path = this->MakeFull(Path);
-        if(!this->IsFile(path)) return false;
-        bool bin = false;
+        auto path = this->MakeFullPath(Path);
+        Hasher hash(Type);
         u64 fsize = this->GetFileSize(path);
-        if(fsize == 0) return true;
-        u64 toread = std::min(fsize, (u64)0x200); // 0x200, like GodMode9
-        u8 *ptr = GetFileSystemOperationsBuffer();
-        u64 rsize = this->ReadFileBlock(path, 0, toread, ptr);
-        for(u32 i = 0; i < rsize; i++)
+        u64 rsize = GetFileSystemOperationsBufferSize();
+        u8 *data = GetFileSystemOperationsBuffer();
+        u64 off = 0;
+        this->StartFile(path, fs::FileMode::Read);
+        while(off < fsize)
         {
-            char ch = (char)ptr[i];
-            if(rsize == 0) return true;
-            if(!isascii(ch) || (iscntrl(ch) && !isspace(ch)))
-            {
-                bin = true;
-                break;
-            }
+            u64 rbytes = this->ReadFileBlock(path, off, std::min(fsize - off, rsize), data);
+            if(rbytes == 0) break;
+            hash.Update(data, rbytes);
+            off += rbytes;
         }
+        this->EndFile(fs::FileMode::Read);
+        return hash.Finish();
+    }
+
+    bool Explorer::IsFileBinary(const Utf8Path &Path)
+    {
+        auto path = this->MakeFullPath(Path);
+        if(!this->IsFile(path)) return false;
+        u64 fsize = this->GetFileSize(path);
+        if(fsize == 0) return true;
+        // Cached results are keyed by size too, so that a modified file gets classified again
+        auto cached = this->bincache.find(path.Str());
+        if((cached != this->bincache.end()) && (cached->second.first == fsize)) return cached->second.second;
+        u8 prefix[BinaryCheckSize];
+        u64 rsize = this->ReadFileBlock(path, 0, std::min(fsize, BinaryCheckSize), prefix);
+        bool bin = (rsize == 0) || IsBinaryData(prefix, rsize);
+        if(this->bincache.size() >= BinaryCacheMaxEntries) this->bincache.clear();
+        this->bincache[path.Str()] = std::make_pair(fsize, bin);
         return bin;
     }
 
-    std::vector<u8> Explorer::ReadFile(String Path)
+    std::vector<u8> Explorer::ReadFile(const Utf8Path &Path)
     {
-        String path = this->MakeFull(Path);
+        auto path = this->MakeFullPath(Path);
         u64 fsize = this->GetFileSize(path);
         std::vector<u8> data;
         if(fsize == 0) return data;
@@ -213,147 +401,43 @@ namespace fs
         return data;
     }
 
-    std::vector<String> Explorer::ReadFileLines(String Path, u32 LineOffset, u32 LineCount)
+    FileView Explorer::OpenView(const Utf8Path &Path)
     {
-        std::vector<String> data;
-        String path = this->MakeFull(Path);
-        u64 fsize = this->GetFileSize(path);
-        if(fsize == 0) return data;
-        String tmpline;
-        u32 tmpc = 0;
-        u32 tmpo = 0;
-        u64 szrem = fsize;
-        u64 off = 0;
-        u8 *tmpdata = GetFileSystemOperationsBuffer();
-        bool end = false;
-        while(szrem && !end)
-        {
-            u64 rsize = this->ReadFileBlock(path, off, std::min((u64)GetFileSystemOperationsBufferSize(), szrem), tmpdata);
-            if(rsize == 0) return data;
-            szrem -= rsize;
-            off += rsize;
-            for(u32 i = 0; i < rsize; i++)
-            {
-                char ch = (char)tmpdata[i];
-                if(ch == '\n')
-                {
-                    if(tmpc >= LineCount)
-                    {
-                        end = true;
-                        break;
-                    }
-                    if((tmpo < LineOffset) && (LineOffset != 0))
-                    {
-                        tmpo++;
-                        tmpline = "";
-                        continue;
-                    }
-                    String tab = "\t";
-                    while(true)
-                    {
-                        size_t spos = tmpline.find(tab);
-                        if(spos == String::npos) break;
-                        tmpline.replace(spos, tab.length(), "    ");
-                    }
-                    data.push_back(tmpline);
-                    tmpc++;
-                    tmpline = "";
-                }
-                else tmpline += (char)ch;
-            }
-        }
-        if(!tmpline.empty())
-        {
-            data.push_back(tmpline);
-            tmpline = "";
-        }
-        return data;
+        return FileView(this, Path);
     }
 
-    std::vector<String> Explorer::ReadFileFormatHex(String Path, u32 LineOffset, u32 LineCount)
-    {
-        std::vector<String> sdata;
-        String path = this->MakeFull(Path);
-        u64 sz = this->GetFileSize(path);
-        u64 off = 16 * LineOffset;
-        u64 rsz = 16 * LineCount;
-        if(off >= sz) return sdata;
-        u64 rrsz = std::min(sz, rsz);
-        if((off + rsz) > sz) rrsz = rsz - ((off + rsz) - sz);
-        std::vector<u8> bdata(rrsz);
-        this->ReadFileBlock(path, off, rrsz, bdata.data());
-        u32 count = 0;
-        String tmpline;
-        String tmpchr;
-        u32 toff = 0;
-        for(u32 i = 0; i < (rrsz + 1); i++)
-        {
-            if(count == 16)
-            {
-                std::stringstream ostrm;
-                ostrm << std::hex << std::setw(8) << std::uppercase << std::setfill('0') << (off + toff);
-                String def = " " + ostrm.str() + "   " + tmpline + "  " + tmpchr;
-                sdata.push_back(def);
-                toff += 16;
-                count = 0;
-                tmpline = "";
-                tmpchr = "";
-            }
-            else if(i == rrsz)
-            {
-                if((rrsz % 16) != 0)
-                {
-                    u32 miss = 16 - count;
-                    for(u32 i = 0; i < miss; i++)
-                    {
-                        tmpline += "   ";
-                        tmpchr += " ";
-                    }
-                }
-                std::stringstream ostrm;
-                ostrm << std::hex << std::setw(8) << std::uppercase << std::setfill('0') << (off + toff);
-                String def = " " + ostrm.str() + "   " + tmpline + "  " + tmpchr;
-                sdata.push_back(def);
-                break;
-            }
-            u8 byte = bdata[i];
-            std::stringstream strm;
-            strm << std::setw(2) << std::uppercase << std::setfill('0') << std::hex << (int)byte;
-            tmpline += strm.str() + " ";
-            if(isprint(byte)) tmpchr += (char)byte;
-            else tmpchr += ".";
-            count++;
-        }
-        bdata.clear();
-        return sdata;
+    std::vector<String> Explorer::ReadFileLines(const Utf8Path &Path, u32 LineOffset, u32 LineCount)
+    {
+        LineIndex index;
+        index.Reset(this, Path);
+        return index.ReadLines(LineOffset, LineCount);
+    }
+
+    std::vector<String> Explorer::ReadFileFormatHex(const Utf8Path &Path, u32 LineOffset, u32 LineCount)
+    {
+        HexView view;
+        view.Reset(this, Path);
+        return view.ReadLines(LineOffset, LineCount);
     }
 
-    u64 Explorer::GetDirectorySize(String Path)
+    u64 Explorer::GetDirectorySize(const Utf8Path &Path)
     {
         u64 sz = 0;
-        String path = this->MakeFull(Path);
+        auto path = this->MakeFullPath(Path);
         auto dirs = this->GetDirectories(path);
-        for(auto &dir: dirs) sz += this->GetDirectorySize(path + "/" + dir);
+        for(auto &dir: dirs) sz += this->GetDirectorySize(path.Join(dir.AsUTF8()));
         auto files = this->GetFiles(path);
-        for(auto &file: files) sz += this->GetFileSize(path + "/" + file);
+        for(auto &file: files) sz += this->GetFileSize(path.Join(file.AsUTF8()));
         return sz;
     }
 
-    void Explorer::DeleteDirectory(String Path)
+    void Explorer::DeleteDirectory(const Utf8Path &Path)
     {
-        String path = this->MakeFull(Path);
+        auto path = this->MakeFullPath(Path);
         auto dirs = this->GetDirectories(path);
-        for(auto &dir: dirs)
-        {
-            String pd = path + "/" + dir;
-            this->DeleteDirectory(pd);
-        }
+        for(auto &dir: dirs) this->DeleteDirectory(path.Join(dir.AsUTF8()));
         auto files = this->GetFiles(path);
-        for(auto &file: files)
-        {
-            String pd = path + "/" + file;
-            this->DeleteFile(pd);
-        }
+        for(auto &file: files) this->DeleteFile(path.Join(file.AsUTF8()));
         this->DeleteDirectorySingle(path);
     }
 }
\ No newline at end of file
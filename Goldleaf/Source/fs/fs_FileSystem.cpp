@@ -29,34 +29,55 @@ namespace fs
     static NANDExplorer *enus = NULL;
     static NANDExplorer *enss = NULL;
     static RemotePCExplorer *epcdrv = NULL;
+    static RamExplorer *eram = NULL;
 
     SdCardExplorer *GetSdCardExplorer()
     {
-        if(esdc == NULL) esdc = new SdCardExplorer();
+        if(esdc == NULL)
+        {
+            esdc = new SdCardExplorer();
+            GetMountTable().Register(esdc);
+        }
         return esdc;
     }
 
     NANDExplorer *GetPRODINFOFExplorer()
     {
-        if(eprd == NULL) eprd = new NANDExplorer(Partition::PRODINFOF);
+        if(eprd == NULL)
+        {
+            eprd = new NANDExplorer(Partition::PRODINFOF);
+            GetMountTable().Register(eprd);
+        }
         return eprd;
     }
 
     NANDExplorer *GetNANDSafeExplorer()
     {
-        if(ensf == NULL) ensf = new NANDExplorer(Partition::NANDSafe);
+        if(ensf == NULL)
+        {
+            ensf = new NANDExplorer(Partition::NANDSafe);
+            GetMountTable().Register(ensf);
+        }
         return ensf;
     }
 
     NANDExplorer *GetNANDUserExplorer()
     {
-        if(enus == NULL) enus = new NANDExplorer(Partition::NANDUser);
+        if(enus == NULL)
+        {
+            enus = new NANDExplorer(Partition::NANDUser);
+            GetMountTable().Register(enus);
+        }
         return enus;
     }
 
     NANDExplorer *GetNANDSystemExplorer()
     {
-        if(enss == NULL) enss = new NANDExplorer(Partition::NANDSystem);
+        if(enss == NULL)
+        {
+            enss = new NANDExplorer(Partition::NANDSystem);
+            GetMountTable().Register(enss);
+        }
         return enss;
     }
 
@@ -72,12 +93,14 @@ namespace fs
                 pth.erase(0, 1);
                 epcdrv->NavigateForward(pth);
             }
+            GetMountTable().Register(epcdrv);
         }
         else
         {
             if(epcdrv->GetMountName() != MountName)
             {
-                delete epcdrv;
+                // Register the new drive before dropping the old one, so the mount never resolves to nothing
+                auto olddrv = epcdrv;
                 epcdrv = new RemotePCExplorer(mname);
                 if(MountName != mname)
                 {
@@ -85,25 +108,38 @@ namespace fs
                     pth.erase(0, 1);
                     epcdrv->NavigateForward(pth);
                 }
+                GetMountTable().Register(epcdrv);
+                // The index might be walking the old drive right now
+                GetFileIndex().Pause();
+                delete olddrv;
+                GetFileIndex().Resume();
             }
         }
         return epcdrv;
     }
 
+    RamExplorer *GetRamExplorer()
+    {
+        if(eram == NULL)
+        {
+            eram = new RamExplorer("gram", "RAM", RamExplorerDefaultMaxSize);
+            GetMountTable().Register(eram);
+        }
+        return eram;
+    }
+
     Explorer *GetExplorerForMountName(String MountName)
     {
-        Explorer *ex = NULL;
-        if(esdc != NULL) if(esdc->GetMountName() == MountName) return esdc;
-        if(eprd != NULL) if(eprd->GetMountName() == MountName) return eprd;
-        if(ensf != NULL) if(ensf->GetMountName() == MountName) return ensf;
-        if(enus != NULL) if(enus->GetMountName() == MountName) return enus;
-        if(enss != NULL) if(enss->GetMountName() == MountName) return enss;
-        if(epcdrv != NULL) if(epcdrv->GetMountName() == MountName) return epcdrv;
-        return ex;
+        return GetMountTable().GetForMountName(MountName.AsUTF8());
+    }
+
+    Explorer *GetExplorerForPath(const Utf8Path &Path)
+    {
+        return GetMountTable().GetForPath(Path.View());
     }
 
-    Explorer *GetExplorerForPath(String Path)
+    std::vector<Explorer*> GetLoadedExplorers()
     {
-        return GetExplorerForMountName(GetPathRoot(Path));
+        return GetMountTable().GetAll();
     }
 }
\ No newline at end of file
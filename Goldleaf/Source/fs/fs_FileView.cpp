@@ -0,0 +1,97 @@
+
+/*
+
+    Goldleaf - Multipurpose homebrew tool for Nintendo Switch
+    Copyright (C) 2018-2019  XorTroll
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+#include <fs/fs_FileSystem.hpp>
+#include <cstring>
+
+namespace fs
+{
+    FileView::FileView(Explorer *Exp, const Utf8Path &Path) : exp(Exp), usecount(0)
+    {
+        this->path = Exp->MakeFullPath(Path);
+        this->fsize = Exp->GetFileSize(this->path);
+    }
+
+    u64 FileView::GetSize()
+    {
+        return this->fsize;
+    }
+
+    FileView::Page *FileView::GetPage(u64 Index)
+    {
+        this->usecount++;
+        u32 lru = 0;
+        for(u32 i = 0; i < this->pages.size(); i++)
+        {
+            if(this->pages[i].Index == Index)
+            {
+                this->pages[i].LastUse = this->usecount;
+                return &this->pages[i];
+            }
+            if(this->pages[i].LastUse < this->pages[lru].LastUse) lru = i;
+        }
+        u64 off = Index * FileViewPageSize;
+        u64 psize = std::min(FileViewPageSize, this->fsize - off);
+        if(this->pages.size() < FileViewMaxPages)
+        {
+            this->pages.emplace_back();
+            lru = this->pages.size() - 1;
+        }
+        auto &page = this->pages[lru];
+        page.Data.resize(psize);
+        if(this->exp->ReadFileBlock(this->path, off, psize, page.Data.data()) != psize)
+        {
+            // Don't keep a page which couldn't be fully read
+            page.Index = UINT64_MAX;
+            page.LastUse = 0;
+            return NULL;
+        }
+        page.Index = Index;
+        page.LastUse = this->usecount;
+        return &page;
+    }
+
+    const u8 *FileView::Get(u64 Offset, u64 Size)
+    {
+        if((Size == 0) || (Offset >= this->fsize) || (Size > (this->fsize - Offset))) return NULL;
+        u64 first = Offset / FileViewPageSize;
+        u64 last = (Offset + Size - 1) / FileViewPageSize;
+        if(first == last)
+        {
+            auto page = this->GetPage(first);
+            if(page == NULL) return NULL;
+            return page->Data.data() + (Offset % FileViewPageSize);
+        }
+        // Ranges crossing page boundaries get gathered into a separate buffer
+        this->span.resize(Size);
+        u64 done = 0;
+        for(u64 i = first; i <= last; i++)
+        {
+            auto page = this->GetPage(i);
+            if(page == NULL) return NULL;
+            u64 poff = (i == first) ? (Offset % FileViewPageSize) : 0;
+            u64 csize = std::min(Size - done, (u64)page->Data.size() - poff);
+            memcpy(this->span.data() + done, page->Data.data() + poff, csize);
+            done += csize;
+        }
+        return this->span.data();
+    }
+}
@@ -140,10 +140,13 @@ namespace fs
         this->fs = FileSystem;
         this->SetNames(MountName, DisplayName);
         fsdevMountDevice(MountName.AsUTF8().c_str(), *this->fs);
+        GetMountTable().Register(this);
     }
 
     FileSystemExplorer::~FileSystemExplorer()
     {
+        // Stop resolving paths to it before the device goes away
+        GetMountTable().Unregister(this);
         fsdevUnmountDevice(this->mntname.AsUTF8().c_str());
     }
 
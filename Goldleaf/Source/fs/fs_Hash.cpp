@@ -0,0 +1,113 @@
+
+/*
+
+    Goldleaf - Multipurpose homebrew tool for Nintendo Switch
+    Copyright (C) 2018-2019  XorTroll
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+#include <fs/fs_Hash.hpp>
+#include <fs/fs_FileSystem.hpp>
+
+namespace fs
+{
+    Hasher::Hasher(HashType Type) : type(Type), crc(0)
+    {
+        // libnx's SHA-256 and CRC32C implementations use the ARMv8 crypto/CRC instructions we build with
+        if(Type == HashType::SHA256) sha256ContextCreate(&this->sha);
+    }
+
+    HashType Hasher::GetType()
+    {
+        return this->type;
+    }
+
+    void Hasher::Update(const void *Data, size_t Size)
+    {
+        switch(this->type)
+        {
+            case HashType::SHA256:
+                sha256ContextUpdate(&this->sha, Data, Size);
+                break;
+            case HashType::CRC32C:
+                this->crc = crc32cCalculateWithSeed(this->crc, Data, Size);
+                break;
+            default:
+                break;
+        }
+    }
+
+    std::vector<u8> Hasher::Finish()
+    {
+        std::vector<u8> hash;
+        switch(this->type)
+        {
+            case HashType::SHA256:
+                hash.resize(SHA256_HASH_SIZE);
+                sha256ContextGetHash(&this->sha, hash.data());
+                break;
+            case HashType::CRC32C:
+                hash.resize(sizeof(u32));
+                for(u32 i = 0; i < sizeof(u32); i++) hash[i] = (u8)(this->crc >> (8 * (3 - i)));
+                break;
+            default:
+                break;
+        }
+        return hash;
+    }
+
+    String FormatHash(std::vector<u8> Hash)
+    {
+        static const char hexchars[] = "0123456789abcdef";
+        std::string str;
+        str.reserve(Hash.size() * 2);
+        for(auto byte: Hash)
+        {
+            str += hexchars[byte >> 4];
+            str += hexchars[byte & 0xf];
+        }
+        return str;
+    }
+
+    void WriteHashManifest(String Path, HashType Type, std::vector<u8> Hash)
+    {
+        // Same layout as sha256sum and similar tools, so dumps can be checked on the PC too
+        std::string line = FormatHash(Hash).AsUTF8() + "  " + GetFileName(Path).AsUTF8() + "\n";
+        WriteFile(Path + "." + HashTypeToString(Type), std::vector<u8>(line.begin(), line.end()));
+    }
+
+    HashType StringToHashType(std::string Str)
+    {
+        auto type = HashType::None;
+        if(Str == "sha256") type = HashType::SHA256;
+        else if(Str == "crc32c") type = HashType::CRC32C;
+        return type;
+    }
+
+    std::string HashTypeToString(HashType Type)
+    {
+        switch(Type)
+        {
+            case HashType::SHA256:
+                return "sha256";
+            case HashType::CRC32C:
+                return "crc32c";
+            default:
+                break;
+        }
+        return "none";
+    }
+}
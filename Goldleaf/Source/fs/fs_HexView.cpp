@@ -0,0 +1,120 @@
+
+/*
+
+    Goldleaf - Multipurpose homebrew tool for Nintendo Switch
+    Copyright (C) 2018-2019  XorTroll
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+#include <fs/fs_FileSystem.hpp>
+
+namespace fs
+{
+    static const char HexDigits[] = "0123456789ABCDEF";
+
+    void FormatHexLine(char *Out, u64 Offset, const u8 *Data, u32 Size)
+    {
+        char *cur = Out;
+        *cur++ = ' ';
+        for(s32 i = 7; i >= 0; i--) *cur++ = HexDigits[(Offset >> (i * 4)) & 0xF];
+        *cur++ = ' ';
+        *cur++ = ' ';
+        *cur++ = ' ';
+        char *chr = cur + (HexLineBytes * 3) + 2;
+        for(u32 i = 0; i < HexLineBytes; i++)
+        {
+            if(i < Size)
+            {
+                u8 byte = Data[i];
+                cur[0] = HexDigits[byte >> 4];
+                cur[1] = HexDigits[byte & 0xF];
+                chr[i] = ((byte >= 0x20) && (byte < 0x7F)) ? (char)byte : '.';
+            }
+            else
+            {
+                cur[0] = ' ';
+                cur[1] = ' ';
+                chr[i] = ' ';
+            }
+            cur[2] = ' ';
+            cur += 3;
+        }
+        cur[0] = ' ';
+        cur[1] = ' ';
+    }
+
+    HexView::HexView() : exp(NULL), fsize(0), usecount(0)
+    {
+    }
+
+    void HexView::Reset(Explorer *Exp, const Utf8Path &Path)
+    {
+        this->exp = Exp;
+        this->path = Exp->MakeFullPath(Path);
+        this->fsize = Exp->GetFileSize(this->path);
+        this->usecount = 0;
+        this->pages.clear();
+    }
+
+    HexView::Page &HexView::GetPage(u64 Offset)
+    {
+        this->usecount++;
+        u32 lru = 0;
+        for(u32 i = 0; i < this->pages.size(); i++)
+        {
+            if(this->pages[i].Offset == Offset)
+            {
+                this->pages[i].LastUse = this->usecount;
+                return this->pages[i];
+            }
+            if(this->pages[i].LastUse < this->pages[lru].LastUse) lru = i;
+        }
+        if(this->pages.size() < HexPageCacheCount)
+        {
+            this->pages.emplace_back();
+            lru = this->pages.size() - 1;
+        }
+        auto &page = this->pages[lru];
+        page.Offset = Offset;
+        page.LastUse = this->usecount;
+        page.Data.resize(HexPageSize);
+        page.Size = this->exp->ReadFileBlock(this->path, Offset, std::min(HexPageSize, this->fsize - Offset), page.Data.data());
+        return page;
+    }
+
+    std::vector<String> HexView::ReadLines(u32 LineOffset, u32 LineCount)
+    {
+        std::vector<String> data;
+        if(this->exp == NULL) return data;
+        u64 off = (u64)LineOffset * HexLineBytes;
+        if(off >= this->fsize) return data;
+        u64 end = std::min(this->fsize, off + ((u64)LineCount * HexLineBytes));
+        std::string line(HexLineLength, ' ');
+        while(off < end)
+        {
+            u32 lsize = std::min((u64)HexLineBytes, end - off);
+            // Pages are a multiple of the line size, so a line never spans two of them
+            auto &page = this->GetPage(off - (off % HexPageSize));
+            u64 poff = off - page.Offset;
+            if(poff >= page.Size) break;
+            lsize = std::min((u64)lsize, page.Size - poff);
+            FormatHexLine(&line[0], off, page.Data.data() + poff, lsize);
+            data.push_back(line);
+            off += lsize;
+        }
+        return data;
+    }
+}
@@ -0,0 +1,494 @@
+
+/*
+
+    Goldleaf - Multipurpose homebrew tool for Nintendo Switch
+    Copyright (C) 2018-2019  XorTroll
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+#include <fs/fs_FileSystem.hpp>
+#include <fs/fs_Index.hpp>
+#include <fstream>
+#include <algorithm>
+#include <numeric>
+
+namespace fs
+{
+    static void LowerAscii(std::string &Str)
+    {
+        for(auto &c: Str) if((c >= 'A') && (c <= 'Z')) c += ('a' - 'A');
+    }
+
+    static u32 MakeTrigram(const char *Str)
+    {
+        return ((u32)(u8)Str[0] << 16) | ((u32)(u8)Str[1] << 8) | (u32)(u8)Str[2];
+    }
+
+    static void WriteIndexString(std::ofstream &Ofs, const std::string &Str)
+    {
+        u16 len = (u16)std::min(Str.length(), (size_t)0xFFFF);
+        Ofs.write((const char*)&len, sizeof(len));
+        Ofs.write(Str.data(), len);
+    }
+
+    static bool ReadIndexString(std::ifstream &Ifs, std::string &Str)
+    {
+        u16 len = 0;
+        if(!Ifs.read((char*)&len, sizeof(len))) return false;
+        Str.resize(len);
+        return (bool)Ifs.read(&Str[0], len);
+    }
+
+    template<typename T>
+    static void WriteIndexValue(std::ofstream &Ofs, T Value)
+    {
+        Ofs.write((const char*)&Value, sizeof(T));
+    }
+
+    template<typename T>
+    static bool ReadIndexValue(std::ifstream &Ifs, T &Value)
+    {
+        return (bool)Ifs.read((char*)&Value, sizeof(T));
+    }
+
+    FileIndex::FileIndex() : paused(0), indexing(false), restart(false), busy(false), stop(false), pass(0), rootidx(0), changed(false), filecount(0), curfileidx(0)
+    {
+        this->worker = std::thread(&FileIndex::WorkerMain, this);
+    }
+
+    FileIndex::~FileIndex()
+    {
+        this->Stop();
+    }
+
+    void FileIndex::AddRoot(String Root)
+    {
+        auto root = Root.AsUTF8();
+        {
+            std::lock_guard<std::mutex> lk(this->lock);
+            if(std::find(this->roots.begin(), this->roots.end(), root) == this->roots.end()) this->roots.push_back(root);
+        }
+        // A pass in progress will get to it too, since roots are walked by index
+        this->Refresh();
+    }
+
+    void FileIndex::Refresh()
+    {
+        std::lock_guard<std::mutex> lk(this->lock);
+        if(this->indexing || this->roots.empty()) return;
+        this->indexing = true;
+        this->restart = true;
+        this->wakecv.notify_all();
+    }
+
+    void FileIndex::WorkerMain()
+    {
+        // The saved index is read here too, so that startup doesn't wait for it
+        std::shared_ptr<SearchTable> table;
+        if(this->Load()) table = this->BuildSearch();
+        std::unique_lock<std::mutex> lk(this->lock);
+        if(table) this->search = table;
+        while(true)
+        {
+            this->wakecv.wait(lk, [&]() { return this->stop || (this->indexing && (this->paused == 0)); });
+            if(this->stop) break;
+            bool start = this->restart;
+            this->restart = false;
+            this->busy = true;
+            lk.unlock();
+            if(start) this->StartPass();
+            bool more = this->Step(IndexStepBudgetNs);
+            lk.lock();
+            this->busy = false;
+            if(!more) this->indexing = false;
+            this->idlecv.notify_all();
+        }
+    }
+
+    bool FileIndex::GetRoot(u32 Index, std::string &Out)
+    {
+        std::lock_guard<std::mutex> lk(this->lock);
+        if(Index >= this->roots.size()) return false;
+        Out = this->roots[Index];
+        return true;
+    }
+
+    void FileIndex::StartPass()
+    {
+        this->pass++;
+        this->rootidx = 0;
+        this->filecount = 0;
+        this->queue.clear();
+        this->curdir.clear();
+        this->curfiles.clear();
+    }
+
+    void FileIndex::StartRoot(const std::string &Root)
+    {
+        if(GetExplorerForPath(Utf8Path(Root)) != NULL)
+        {
+            this->queue.push_back(Root);
+            return;
+        }
+        // Not mounted right now (a PC drive, usually): keep what was indexed for it so it's still searchable
+        for(auto &[path, dir]: this->dirs)
+        {
+            if(path.compare(0, Root.length(), Root) == 0)
+            {
+                dir.Pass = this->pass;
+                this->filecount += dir.Files.size();
+            }
+        }
+    }
+
+    void FileIndex::VisitDirectory(const std::string &Path)
+    {
+        auto exp = GetExplorerForPath(Utf8Path(Path));
+        if(exp == NULL) return;
+        auto it = this->dirs.find(Path);
+        // Reached twice through nested roots
+        if((it != this->dirs.end()) && (it->second.Pass == this->pass)) return;
+        Utf8Path path(Path);
+        u64 mtime = exp->GetModifiedTime(path);
+        if((it != this->dirs.end()) && (mtime != 0) && (it->second.ModifiedTime == mtime))
+        {
+            it->second.Pass = this->pass;
+            this->filecount += it->second.Files.size();
+            for(auto &sub: it->second.Directories) this->queue.push_back(path.Join(sub).Str());
+            return;
+        }
+        auto &dir = this->dirs[Path];
+        dir.ModifiedTime = mtime;
+        dir.Pass = this->pass;
+        dir.Directories.clear();
+        dir.Files.clear();
+        for(auto &sub: exp->GetDirectories(path))
+        {
+            auto subname = sub.AsUTF8();
+            this->queue.push_back(path.Join(subname).Str());
+            dir.Directories.push_back(std::move(subname));
+        }
+        this->curfiles.clear();
+        for(auto &file: exp->GetFiles(path))
+        {
+            if(this->filecount >= IndexMaxFiles) break;
+            this->curfiles.push_back(file.AsUTF8());
+            this->filecount++;
+        }
+        this->curdir = Path;
+        this->curfileidx = 0;
+        this->changed = true;
+    }
+
+    bool FileIndex::Step(u64 BudgetNs)
+    {
+        u64 start = armGetSystemTick();
+        while(armTicksToNs(armGetSystemTick() - start) < BudgetNs)
+        {
+            if(!this->curdir.empty())
+            {
+                // Files are stat'ed one by one, so that a pause doesn't have to wait for a whole big directory
+                auto exp = GetExplorerForPath(Utf8Path(this->curdir));
+                if(exp != NULL)
+                {
+                    auto &dir = this->dirs[this->curdir];
+                    Utf8Path path(this->curdir);
+                    while((this->curfileidx < this->curfiles.size()) && (armTicksToNs(armGetSystemTick() - start) < BudgetNs))
+                    {
+                        IndexedFile file = {};
+                        file.Name = this->curfiles[this->curfileidx];
+                        exp->GetFileInfo(path.Join(file.Name), file.Size, file.ModifiedTime);
+                        dir.Files.push_back(std::move(file));
+                        this->curfileidx++;
+                    }
+                    if(this->curfileidx < this->curfiles.size()) break;
+                }
+                // Unmounted halfway, make sure the partial listing isn't trusted next time
+                else this->dirs[this->curdir].ModifiedTime = 0;
+                this->curdir.clear();
+                this->curfiles.clear();
+                continue;
+            }
+            if(!this->queue.empty())
+            {
+                auto path = std::move(this->queue.front());
+                this->queue.pop_front();
+                this->VisitDirectory(path);
+                continue;
+            }
+            std::string root;
+            if(!this->GetRoot(this->rootidx, root))
+            {
+                this->FinishPass();
+                return false;
+            }
+            this->rootidx++;
+            this->StartRoot(root);
+        }
+        return true;
+    }
+
+    void FileIndex::FinishPass()
+    {
+        for(auto it = this->dirs.begin(); it != this->dirs.end();)
+        {
+            if(it->second.Pass != this->pass)
+            {
+                it = this->dirs.erase(it);
+                this->changed = true;
+            }
+            else ++it;
+        }
+        if(this->changed)
+        {
+            auto table = this->BuildSearch();
+            {
+                std::lock_guard<std::mutex> lk(this->lock);
+                this->search = table;
+            }
+            this->Save();
+            this->changed = false;
+        }
+    }
+
+    bool FileIndex::IsIndexing()
+    {
+        std::lock_guard<std::mutex> lk(this->lock);
+        return this->indexing;
+    }
+
+    // Installs stream from the same explorers, so the walk steps aside: this returns once the worker is between two steps
+    void FileIndex::Pause()
+    {
+        std::unique_lock<std::mutex> lk(this->lock);
+        this->paused++;
+        this->idlecv.wait(lk, [&]() { return !this->busy; });
+    }
+
+    void FileIndex::Resume()
+    {
+        std::lock_guard<std::mutex> lk(this->lock);
+        if(this->paused > 0) this->paused--;
+        this->wakecv.notify_all();
+    }
+
+    // Must be called before the explorers get deleted
+    void FileIndex::Stop()
+    {
+        {
+            std::lock_guard<std::mutex> lk(this->lock);
+            this->stop = true;
+            this->wakecv.notify_all();
+        }
+        if(this->worker.joinable()) this->worker.join();
+    }
+
+    u32 FileIndex::GetFileCount()
+    {
+        std::lock_guard<std::mutex> lk(this->lock);
+        if(!this->search) return 0;
+        return this->search->Entries.size();
+    }
+
+    std::shared_ptr<FileIndex::SearchTable> FileIndex::BuildSearch()
+    {
+        auto table = std::make_shared<SearchTable>();
+        for(auto &[path, dir]: this->dirs)
+        {
+            if(dir.Files.empty()) continue;
+            u32 didx = table->Directories.size();
+            table->Directories.push_back(path);
+            for(auto &file: dir.Files)
+            {
+                SearchEntry ent = { didx, (u32)table->Names.length(), (u32)file.Name.length(), file.Size, file.ModifiedTime };
+                table->Names += file.Name;
+                table->Entries.push_back(ent);
+            }
+        }
+        table->LowerNames = table->Names;
+        LowerAscii(table->LowerNames);
+        auto lname = [&](u32 Id)
+        {
+            auto &ent = table->Entries[Id];
+            return std::string_view(table->LowerNames.data() + ent.NameOffset, ent.NameLength);
+        };
+        table->ByName.resize(table->Entries.size());
+        std::iota(table->ByName.begin(), table->ByName.end(), 0);
+        std::sort(table->ByName.begin(), table->ByName.end(), [&](u32 A, u32 B) { return lname(A) < lname(B); });
+        for(u32 i = 0; i < table->Entries.size(); i++)
+        {
+            auto name = lname(i);
+            for(u32 j = 0; (j + 3) <= name.length(); j++)
+            {
+                auto &ids = table->Trigrams[MakeTrigram(name.data() + j)];
+                if(ids.empty() || (ids.back() != i)) ids.push_back(i);
+            }
+        }
+        return table;
+    }
+
+    std::vector<IndexResult> FileIndex::Search(String Query, u32 MaxResults)
+    {
+        std::vector<IndexResult> results;
+        auto query = Query.AsUTF8();
+        LowerAscii(query);
+        if(query.empty()) return results;
+        // The worker only ever swaps in a new table, so this one can be read without holding the lock
+        std::shared_ptr<SearchTable> table;
+        {
+            std::lock_guard<std::mutex> lk(this->lock);
+            table = this->search;
+        }
+        if(!table) return results;
+        auto lname = [&](u32 Id)
+        {
+            auto &ent = table->Entries[Id];
+            return std::string_view(table->LowerNames.data() + ent.NameOffset, ent.NameLength);
+        };
+        std::vector<u32> ids;
+        if(query.length() < 3)
+        {
+            // Too short for trigrams, match name prefixes instead
+            auto it = std::lower_bound(table->ByName.begin(), table->ByName.end(), query, [&](u32 Id, const std::string &Q) { return lname(Id).substr(0, Q.length()) < Q; });
+            for(; (it != table->ByName.end()) && (ids.size() < MaxResults); ++it)
+            {
+                if(lname(*it).substr(0, query.length()) != query) break;
+                ids.push_back(*it);
+            }
+        }
+        else
+        {
+            // Candidates come from the rarest trigram of the query, then get checked against the whole of it
+            const std::vector<u32> *cands = NULL;
+            for(u32 i = 0; (i + 3) <= query.length(); i++)
+            {
+                auto it = table->Trigrams.find(MakeTrigram(query.data() + i));
+                if(it == table->Trigrams.end()) return results;
+                if((cands == NULL) || (it->second.size() < cands->size())) cands = &it->second;
+            }
+            for(auto id: *cands)
+            {
+                if(lname(id).find(query) == std::string_view::npos) continue;
+                ids.push_back(id);
+                if(ids.size() >= MaxResults) break;
+            }
+        }
+        for(auto id: ids)
+        {
+            auto &ent = table->Entries[id];
+            IndexResult res = {};
+            res.Path = Utf8Path(table->Directories[ent.Directory]).Join(std::string_view(table->Names.data() + ent.NameOffset, ent.NameLength)).ToString();
+            res.Size = ent.Size;
+            res.ModifiedTime = ent.ModifiedTime;
+            results.push_back(res);
+        }
+        return results;
+    }
+
+    bool FileIndex::Load()
+    {
+        std::ifstream ifs(GetFileIndexPath().AsUTF8(), std::ios::binary);
+        if(!ifs.good()) return false;
+        u32 magic = 0;
+        u32 version = 0;
+        if(!ReadIndexValue(ifs, magic) || (magic != IndexMagic)) return false;
+        if(!ReadIndexValue(ifs, version) || (version != IndexVersion)) return false;
+        std::vector<std::string> lroots;
+        std::unordered_map<std::string, IndexedDirectory> ldirs;
+        u32 rootcount = 0;
+        if(!ReadIndexValue(ifs, rootcount)) return false;
+        for(u32 i = 0; i < rootcount; i++)
+        {
+            std::string root;
+            if(!ReadIndexString(ifs, root)) return false;
+            lroots.push_back(root);
+        }
+        u32 dircount = 0;
+        if(!ReadIndexValue(ifs, dircount)) return false;
+        for(u32 i = 0; i < dircount; i++)
+        {
+            std::string path;
+            IndexedDirectory dir = {};
+            u32 subcount = 0;
+            u32 fcount = 0;
+            if(!ReadIndexString(ifs, path) || !ReadIndexValue(ifs, dir.ModifiedTime) || !ReadIndexValue(ifs, subcount) || !ReadIndexValue(ifs, fcount)) return false;
+            for(u32 j = 0; j < subcount; j++)
+            {
+                std::string sub;
+                if(!ReadIndexString(ifs, sub)) return false;
+                dir.Directories.push_back(std::move(sub));
+            }
+            for(u32 j = 0; j < fcount; j++)
+            {
+                IndexedFile file = {};
+                if(!ReadIndexString(ifs, file.Name) || !ReadIndexValue(ifs, file.Size) || !ReadIndexValue(ifs, file.ModifiedTime)) return false;
+                dir.Files.push_back(std::move(file));
+            }
+            ldirs[path] = std::move(dir);
+        }
+        {
+            std::lock_guard<std::mutex> lk(this->lock);
+            for(auto &root: lroots) if(std::find(this->roots.begin(), this->roots.end(), root) == this->roots.end()) this->roots.push_back(root);
+        }
+        this->dirs = std::move(ldirs);
+        return true;
+    }
+
+    bool FileIndex::Save()
+    {
+        std::ofstream ofs(GetFileIndexPath().AsUTF8(), std::ios::binary | std::ios::trunc);
+        if(!ofs.good()) return false;
+        WriteIndexValue(ofs, IndexMagic);
+        WriteIndexValue(ofs, IndexVersion);
+        std::vector<std::string> sroots;
+        {
+            std::lock_guard<std::mutex> lk(this->lock);
+            sroots = this->roots;
+        }
+        WriteIndexValue(ofs, (u32)sroots.size());
+        for(auto &root: sroots) WriteIndexString(ofs, root);
+        WriteIndexValue(ofs, (u32)this->dirs.size());
+        for(auto &[path, dir]: this->dirs)
+        {
+            WriteIndexString(ofs, path);
+            WriteIndexValue(ofs, dir.ModifiedTime);
+            WriteIndexValue(ofs, (u32)dir.Directories.size());
+            WriteIndexValue(ofs, (u32)dir.Files.size());
+            for(auto &sub: dir.Directories) WriteIndexString(ofs, sub);
+            for(auto &file: dir.Files)
+            {
+                WriteIndexString(ofs, file.Name);
+                WriteIndexValue(ofs, file.Size);
+                WriteIndexValue(ofs, file.ModifiedTime);
+            }
+        }
+        bool ok = ofs.good();
+        ofs.close();
+        return ok;
+    }
+
+    FileIndex &GetFileIndex()
+    {
+        static FileIndex index;
+        return index;
+    }
+
+    String GetFileIndexPath()
+    {
+        return "sdmc:/" + consts::Root + "/fileindex.bin";
+    }
+}
@@ -0,0 +1,158 @@
+
+/*
+
+    Goldleaf - Multipurpose homebrew tool for Nintendo Switch
+    Copyright (C) 2018-2019  XorTroll
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+#include <fs/fs_FileSystem.hpp>
+#include <fstream>
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+
+namespace fs
+{
+    static bool ReadCopyJournal(const Utf8Path &Destination, JSON &Out)
+    {
+        std::ifstream ifs(GetCopyJournalPath(Destination).AsUTF8());
+        if(!ifs.good()) return false;
+        bool ok = true;
+        try
+        {
+            Out = JSON::parse(ifs);
+        }
+        catch(std::exception&)
+        {
+            ok = false;
+        }
+        ifs.close();
+        return ok;
+    }
+
+    CopyJournal::CopyJournal(const Utf8Path &Source, const Utf8Path &Destination) : src(Source.Str()), dst(Destination.Str()), curoffset(0), flushoffset(0), flushcount(0)
+    {
+        JSON journal;
+        if(ReadCopyJournal(Destination, journal))
+        {
+            // Only resume if the journal belongs to this exact copy (the same destination from another source doesn't), otherwise it gets replaced on the next flush
+            if((journal.value("source", "") == this->src) && (journal.value("destination", "") == this->dst))
+            {
+                if(journal.count("completed")) for(auto &cfile: journal["completed"]) this->completed.push_back(cfile.get<std::string>());
+                this->completedset.insert(this->completed.begin(), this->completed.end());
+                this->curfile = journal.value("current", "");
+                this->curoffset = journal.value("offset", (u64)0);
+            }
+        }
+    }
+
+    bool CopyJournal::CanResume(const Utf8Path &Source, const Utf8Path &Destination)
+    {
+        JSON journal;
+        if(!ReadCopyJournal(Destination, journal)) return false;
+        return ((journal.value("source", "") == Source.Str()) && (journal.value("destination", "") == Destination.Str()));
+    }
+
+    bool CopyJournal::IsFileCompleted(const Utf8Path &Path)
+    {
+        return (this->completedset.count(Path.Str()) > 0);
+    }
+
+    u64 CopyJournal::GetResumeOffset(Explorer *Exp, const Utf8Path &Path, Explorer *NewExp, const Utf8Path &NewPath)
+    {
+        if(this->curfile.empty() || (this->curfile != NewPath.Str())) return 0;
+        // What actually reached the destination is what counts, the journal offset might be older
+        u64 off = NewExp->GetFileSize(NewPath);
+        if(off > this->curoffset)
+        {
+            // A preallocated destination is already at its final size, so cut it back to the checkpoint
+            if(NewExp->AllocateFile(NewPath, this->curoffset)) off = this->curoffset;
+        }
+        if((off == 0) || (off > Exp->GetFileSize(Path))) return 0;
+        u64 tailsz = std::min(off, JournalTailCheckSize);
+        std::vector<u8> srctail(tailsz);
+        std::vector<u8> dsttail(tailsz);
+        Exp->StartFile(Path, FileMode::Read);
+        u64 srcread = Exp->ReadFileBlock(Path, off - tailsz, tailsz, srctail.data());
+        Exp->EndFile(FileMode::Read);
+        NewExp->StartFile(NewPath, FileMode::Read);
+        u64 dstread = NewExp->ReadFileBlock(NewPath, off - tailsz, tailsz, dsttail.data());
+        NewExp->EndFile(FileMode::Read);
+        if((srcread != tailsz) || (dstread != tailsz)) return 0;
+        if(memcmp(srctail.data(), dsttail.data(), tailsz) != 0) return 0;
+        return off;
+    }
+
+    void CopyJournal::SetProgress(const Utf8Path &NewPath, u64 Offset)
+    {
+        this->curfile = NewPath.Str();
+        this->curoffset = Offset;
+        if((Offset - std::min(Offset, this->flushoffset)) >= JournalFlushInterval) this->Flush();
+    }
+
+    void CopyJournal::SetFileCompleted(const Utf8Path &NewPath)
+    {
+        this->completed.push_back(NewPath.Str());
+        this->completedset.insert(NewPath.Str());
+        this->curfile = "";
+        this->curoffset = 0;
+        this->flushoffset = 0;
+        this->flushcount++;
+        if(this->flushcount >= JournalFlushFileCount) this->Flush();
+    }
+
+    bool CopyJournal::IsPending()
+    {
+        return !this->curfile.empty();
+    }
+
+    void CopyJournal::Flush()
+    {
+        auto journal = JSON::object();
+        journal["source"] = this->src;
+        journal["destination"] = this->dst;
+        journal["completed"] = this->completed;
+        journal["current"] = this->curfile;
+        journal["offset"] = this->curoffset;
+        CreateDirectory("sdmc:/" + consts::Root + "/journal");
+        std::ofstream ofs(GetCopyJournalPath(this->dst).AsUTF8());
+        ofs << journal;
+        ofs.close();
+        this->flushoffset = this->curoffset;
+        this->flushcount = 0;
+    }
+
+    void CopyJournal::Finish()
+    {
+        auto path = GetCopyJournalPath(this->dst);
+        if(IsFile(path)) DeleteFile(path);
+    }
+
+    String GetCopyJournalPath(const Utf8Path &Destination)
+    {
+        // FNV-1a of the destination path
+        u64 hash = 0xCBF29CE484222325;
+        for(auto c: Destination.View())
+        {
+            hash ^= (u8)c;
+            hash *= 0x100000001B3;
+        }
+        char name[0x20] = {};
+        snprintf(name, sizeof(name), "%016llX.json", (unsigned long long)hash);
+        return "sdmc:/" + consts::Root + "/journal/" + name;
+    }
+}
@@ -0,0 +1,144 @@
+
+/*
+
+    Goldleaf - Multipurpose homebrew tool for Nintendo Switch
+    Copyright (C) 2018-2019  XorTroll
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+#include <fs/fs_FileSystem.hpp>
+#include <cstring>
+
+namespace fs
+{
+    LineIndex::LineIndex() : exp(NULL), fsize(0), scanoff(0), lines(0)
+    {
+    }
+
+    void LineIndex::Reset(Explorer *Exp, const Utf8Path &Path)
+    {
+        this->exp = Exp;
+        this->path = Exp->MakeFullPath(Path);
+        this->fsize = Exp->GetFileSize(this->path);
+        this->scanoff = 0;
+        this->lines = 0;
+        this->checkpoints.clear();
+        if(this->fsize > 0)
+        {
+            this->checkpoints.push_back(0);
+            this->lines = 1;
+        }
+    }
+
+    bool LineIndex::IndexNextBlock(u64 BlockSize)
+    {
+        if(this->IsComplete()) return false;
+        u64 toread = std::min(BlockSize, this->fsize - this->scanoff);
+        this->block.resize(toread);
+        u64 rbytes = this->exp->ReadFileBlock(this->path, this->scanoff, toread, this->block.data());
+        if(rbytes == 0)
+        {
+            // Treat a failed read as the end of the file, so that nothing keeps retrying it
+            this->fsize = this->scanoff;
+            return false;
+        }
+        u8 *start = this->block.data();
+        u8 *end = start + rbytes;
+        u8 *cur = start;
+        while(cur < end)
+        {
+            auto nl = (u8*)memchr(cur, '\n', end - cur);
+            if(nl == NULL) break;
+            u64 lstart = this->scanoff + (nl - start) + 1;
+            if(lstart < this->fsize)
+            {
+                if((this->lines % LineIndexStride) == 0) this->checkpoints.push_back(lstart);
+                this->lines++;
+            }
+            cur = nl + 1;
+        }
+        this->scanoff += rbytes;
+        return true;
+    }
+
+    bool LineIndex::Step(u64 BudgetNs)
+    {
+        u64 start = armGetSystemTick();
+        while(armTicksToNs(armGetSystemTick() - start) < BudgetNs)
+        {
+            if(!this->IndexNextBlock(LineIndexStepBlockSize)) return false;
+        }
+        return true;
+    }
+
+    void LineIndex::IndexUntil(u32 Line)
+    {
+        while((this->lines <= Line) && this->IndexNextBlock());
+    }
+
+    bool LineIndex::IsComplete()
+    {
+        return (this->exp == NULL) || (this->scanoff >= this->fsize);
+    }
+
+    u32 LineIndex::GetLineCount()
+    {
+        return this->lines;
+    }
+
+    std::vector<String> LineIndex::ReadLines(u32 LineOffset, u32 LineCount)
+    {
+        std::vector<String> data;
+        // The window ends at the checkpoint after its last line, which has to be indexed (unless the file ends first) so that the read doesn't fall back to the file size
+        u32 endcp = (LineOffset + LineCount + LineIndexStride - 1) / LineIndexStride;
+        this->IndexUntil(endcp * LineIndexStride);
+        if(LineOffset >= this->lines) return data;
+        u32 cpidx = LineOffset / LineIndexStride;
+        u64 off = this->checkpoints[cpidx];
+        u64 endoff = (endcp < this->checkpoints.size()) ? this->checkpoints[endcp] : this->fsize;
+        u64 rsize = std::min(endoff - off, LineWindowMaxSize);
+        std::vector<u8> window(rsize);
+        rsize = this->exp->ReadFileBlock(this->path, off, rsize, window.data());
+        char *cur = (char*)window.data();
+        char *end = cur + rsize;
+        u32 skip = LineOffset - (cpidx * LineIndexStride);
+        while((cur < end) && (data.size() < LineCount))
+        {
+            auto nl = (char*)memchr(cur, '\n', end - cur);
+            char *lend = (nl != NULL) ? nl : end;
+            if(skip > 0) skip--;
+            else
+            {
+                std::string line;
+                line.reserve(lend - cur);
+                // Whole runs between tabs get appended at once
+                for(char *run = cur; run < lend;)
+                {
+                    auto tab = (char*)memchr(run, '\t', lend - run);
+                    char *rend = (tab != NULL) ? tab : lend;
+                    line.append(run, rend - run);
+                    if(tab == NULL) break;
+                    line += "    ";
+                    run = tab + 1;
+                }
+                data.push_back(line);
+            }
+            if(nl == NULL) break;
+            cur = nl + 1;
+        }
+        return data;
+    }
+}
@@ -0,0 +1,203 @@
+
+/*
+
+    Goldleaf - Multipurpose homebrew tool for Nintendo Switch
+    Copyright (C) 2018-2019  XorTroll
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+#include <fs/fs_MountTable.hpp>
+#include <fs/fs_Explorer.hpp>
+#include <cstring>
+
+namespace fs
+{
+    static u32 HashMountName(std::string_view MountName)
+    {
+        u32 hash = 2166136261u;
+        for(auto c: MountName)
+        {
+            hash ^= (u8)c;
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    static std::string_view GetRootView(std::string_view Path)
+    {
+        return Path.substr(0, Path.find(':'));
+    }
+
+    MountTable::MountTable()
+    {
+        for(u32 i = 0; i < MaxMounts; i++)
+        {
+            this->slots[i].used.store(false, std::memory_order_relaxed);
+            this->slots[i].seq.store(0, std::memory_order_relaxed);
+            this->slots[i].namelen.store(0, std::memory_order_relaxed);
+            this->slots[i].exp.store(NULL, std::memory_order_relaxed);
+        }
+    }
+
+    bool MountTable::HasName(Slot &Entry, std::string_view MountName, u32 &Sequence)
+    {
+        while(true)
+        {
+            u32 seq = Entry.seq.load(std::memory_order_acquire);
+            if(seq & 1) continue;
+            bool eq = (Entry.namelen.load(std::memory_order_relaxed) == MountName.length()) && (memcmp(Entry.name, MountName.data(), MountName.length()) == 0);
+            // Only trust the comparison if the name wasn't rewritten while it was being read
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if(Entry.seq.load(std::memory_order_relaxed) != seq) continue;
+            Sequence = seq;
+            return eq;
+        }
+    }
+
+    void MountTable::SetName(Slot &Entry, std::string_view MountName)
+    {
+        // Called with the lock held, so there's a single writer
+        u32 seq = Entry.seq.load(std::memory_order_relaxed);
+        Entry.seq.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        memcpy(Entry.name, MountName.data(), MountName.length());
+        Entry.namelen.store(MountName.length(), std::memory_order_relaxed);
+        Entry.seq.store(seq + 2, std::memory_order_release);
+    }
+
+    MountId MountTable::Intern(std::string_view MountName)
+    {
+        // Called with the lock held, the name is written before the slot gets published
+        if(MountName.length() > MountNameMaxLength) return InvalidMountId;
+        u32 start = HashMountName(MountName) % MaxMounts;
+        MountId freeid = InvalidMountId;
+        for(u32 i = 0; i < MaxMounts; i++)
+        {
+            u32 idx = (start + i) % MaxMounts;
+            auto &slot = this->slots[idx];
+            u32 seq = 0;
+            if(!slot.used.load(std::memory_order_acquire))
+            {
+                if(freeid == InvalidMountId) freeid = idx + 1;
+                break;
+            }
+            if(HasName(slot, MountName, seq)) return idx + 1;
+            // Its explorer is gone, so the name can be replaced (the slot stays used, which keeps probe chains through it intact)
+            if((freeid == InvalidMountId) && (slot.exp.load(std::memory_order_acquire) == NULL)) freeid = idx + 1;
+        }
+        if(freeid == InvalidMountId) return InvalidMountId;
+        auto &slot = this->slots[freeid - 1];
+        SetName(slot, MountName);
+        slot.used.store(true, std::memory_order_release);
+        return freeid;
+    }
+
+    MountId MountTable::Register(Explorer *Exp)
+    {
+        if(Exp == NULL) return InvalidMountId;
+        std::lock_guard<std::mutex> lk(this->lock);
+        MountId id = this->Intern(Exp->GetMountName().AsUTF8());
+        if(id != InvalidMountId) this->slots[id - 1].exp.store(Exp, std::memory_order_release);
+        return id;
+    }
+
+    void MountTable::Unregister(Explorer *Exp)
+    {
+        if(Exp == NULL) return;
+        std::lock_guard<std::mutex> lk(this->lock);
+        MountId id = this->Lookup(Exp->GetMountName().AsUTF8());
+        if(id == InvalidMountId) return;
+        // Another explorer might have been registered for the same name meanwhile, keep that one
+        Explorer *cur = Exp;
+        this->slots[id - 1].exp.compare_exchange_strong(cur, NULL, std::memory_order_acq_rel);
+    }
+
+    MountId MountTable::Find(std::string_view MountName, u32 &Sequence)
+    {
+        u32 start = HashMountName(MountName) % MaxMounts;
+        for(u32 i = 0; i < MaxMounts; i++)
+        {
+            u32 idx = (start + i) % MaxMounts;
+            auto &slot = this->slots[idx];
+            // Reused slots stay used, so the first unused one still ends the probe
+            if(!slot.used.load(std::memory_order_acquire)) break;
+            if(HasName(slot, MountName, Sequence)) return idx + 1;
+        }
+        return InvalidMountId;
+    }
+
+    Explorer *MountTable::Resolve(std::string_view MountName)
+    {
+        while(true)
+        {
+            u32 seq = 0;
+            MountId id = this->Find(MountName, seq);
+            if(id == InvalidMountId) return NULL;
+            auto &slot = this->slots[id - 1];
+            auto exp = slot.exp.load(std::memory_order_acquire);
+            // The slot was given to another name after it matched, so its explorer isn't ours
+            if(slot.seq.load(std::memory_order_acquire) != seq) continue;
+            return exp;
+        }
+    }
+
+    MountId MountTable::Lookup(std::string_view MountName)
+    {
+        u32 seq = 0;
+        return this->Find(MountName, seq);
+    }
+
+    MountId MountTable::LookupPath(std::string_view Path)
+    {
+        return this->Lookup(GetRootView(Path));
+    }
+
+    Explorer *MountTable::Get(MountId Id)
+    {
+        if((Id == InvalidMountId) || (Id > MaxMounts)) return NULL;
+        return this->slots[Id - 1].exp.load(std::memory_order_acquire);
+    }
+
+    Explorer *MountTable::GetForMountName(std::string_view MountName)
+    {
+        return this->Resolve(MountName);
+    }
+
+    Explorer *MountTable::GetForPath(std::string_view Path)
+    {
+        return this->Resolve(GetRootView(Path));
+    }
+
+    std::vector<Explorer*> MountTable::GetAll()
+    {
+        std::vector<Explorer*> exps;
+        for(u32 i = 0; i < MaxMounts; i++)
+        {
+            auto &slot = this->slots[i];
+            if(!slot.used.load(std::memory_order_acquire)) continue;
+            auto exp = slot.exp.load(std::memory_order_acquire);
+            if(exp != NULL) exps.push_back(exp);
+        }
+        return exps;
+    }
+
+    MountTable &GetMountTable()
+    {
+        static MountTable table;
+        return table;
+    }
+}
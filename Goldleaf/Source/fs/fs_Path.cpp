@@ -0,0 +1,122 @@
+
+/*
+
+    Goldleaf - Multipurpose homebrew tool for Nintendo Switch
+    Copyright (C) 2018-2019  XorTroll
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+#include <fs/fs_Path.hpp>
+
+namespace fs
+{
+    Utf8Path::Utf8Path()
+    {
+    }
+
+    Utf8Path::Utf8Path(const char *Str) : str(Str)
+    {
+    }
+
+    Utf8Path::Utf8Path(std::string Str) : str(std::move(Str))
+    {
+    }
+
+    Utf8Path::Utf8Path(std::string_view Str) : str(Str)
+    {
+    }
+
+    Utf8Path::Utf8Path(String Str) : str(Str.AsUTF8())
+    {
+    }
+
+    const char *Utf8Path::CStr() const
+    {
+        return this->str.c_str();
+    }
+
+    const std::string &Utf8Path::Str() const
+    {
+        return this->str;
+    }
+
+    std::string_view Utf8Path::View() const
+    {
+        return this->str;
+    }
+
+    bool Utf8Path::IsEmpty() const
+    {
+        return this->str.empty();
+    }
+
+    std::string_view Utf8Path::GetRoot() const
+    {
+        return this->View().substr(0, this->str.find(':'));
+    }
+
+    std::string_view Utf8Path::GetWithoutRoot() const
+    {
+        auto pos = this->str.find(':');
+        if(pos == std::string::npos) return this->View();
+        return this->View().substr(pos + 1);
+    }
+
+    std::string_view Utf8Path::GetFileName() const
+    {
+        auto pos = this->str.find_last_of("/\\");
+        if(pos == std::string::npos) return this->View();
+        return this->View().substr(pos + 1);
+    }
+
+    std::string_view Utf8Path::GetBaseDirectory() const
+    {
+        return this->View().substr(0, this->str.find_last_of("/\\"));
+    }
+
+    std::string_view Utf8Path::GetExtension() const
+    {
+        auto pos = this->str.find_last_of('.');
+        if(pos == std::string::npos) return std::string_view();
+        return this->View().substr(pos + 1);
+    }
+
+    Utf8Path &Utf8Path::Append(std::string_view Name)
+    {
+        if(!this->str.empty() && (this->str.back() != '/')) this->str += '/';
+        this->str.append(Name);
+        return *this;
+    }
+
+    Utf8Path Utf8Path::Join(std::string_view Name) const
+    {
+        Utf8Path path;
+        path.Reserve(this->str.length() + 1 + Name.length());
+        path.str = this->str;
+        path.Append(Name);
+        return path;
+    }
+
+    void Utf8Path::Reserve(size_t Size)
+    {
+        this->str.reserve(Size);
+    }
+
+    String Utf8Path::ToString() const
+    {
+        return String(this->str);
+    }
+}
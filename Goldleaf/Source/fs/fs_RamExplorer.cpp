@@ -0,0 +1,297 @@
+
+/*
+
+    Goldleaf - Multipurpose homebrew tool for Nintendo Switch
+    Copyright (C) 2018-2019  XorTroll
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+#include <fs/fs_FileSystem.hpp>
+#include <err/err_Result.hpp>
+#include <cstring>
+
+namespace fs
+{
+    RamExplorer::RamExplorer(String MountName, String DisplayName, u64 MaxSize) : maxsize(MaxSize), usedsize(0), w_off(0), dir_idx(0)
+    {
+        this->SetNames(MountName, DisplayName);
+    }
+
+    std::string RamExplorer::Normalize(const Utf8Path &Path)
+    {
+        std::string path = this->MakeFullPath(Path).Str();
+        while((path.length() > this->mntroot.length()) && (path.back() == '/')) path.pop_back();
+        return path;
+    }
+
+    std::vector<std::string> RamExplorer::ListChildren(const std::string &Dir, bool Directories)
+    {
+        std::vector<std::string> children;
+        std::string prefix = Dir;
+        if(prefix.back() != '/') prefix += "/";
+        auto check = [&](const std::string &Entry)
+        {
+            if((Entry.length() > prefix.length()) && (Entry.compare(0, prefix.length(), prefix) == 0))
+            {
+                auto name = Entry.substr(prefix.length());
+                if(name.find('/') == std::string::npos) children.push_back(name);
+            }
+        };
+        if(Directories) for(auto &dir: this->dirs) check(dir);
+        else for(auto &file: this->files) check(file.first);
+        return children;
+    }
+
+    bool RamExplorer::Resize(std::vector<u8> &Data, u64 Size)
+    {
+        if(Size > Data.size())
+        {
+            u64 grow = Size - Data.size();
+            if(grow > (this->maxsize - this->usedsize)) return false;
+            this->usedsize += grow;
+        }
+        else this->usedsize -= (Data.size() - Size);
+        Data.resize(Size);
+        return true;
+    }
+
+    std::vector<String> RamExplorer::GetDirectories(const Utf8Path &Path)
+    {
+        u64 tick = armGetSystemTick();
+        std::vector<String> dirs;
+        for(auto &dir: this->ListChildren(this->Normalize(Path), true)) dirs.push_back(dir);
+        this->stats.Record(IoOperation::List, tick, 0, false);
+        return dirs;
+    }
+
+    std::vector<String> RamExplorer::GetFiles(const Utf8Path &Path)
+    {
+        u64 tick = armGetSystemTick();
+        std::vector<String> files;
+        for(auto &file: this->ListChildren(this->Normalize(Path), false)) files.push_back(file);
+        this->stats.Record(IoOperation::List, tick, 0, false);
+        return files;
+    }
+
+    bool RamExplorer::Exists(const Utf8Path &Path)
+    {
+        return (this->IsFile(Path) || this->IsDirectory(Path));
+    }
+
+    bool RamExplorer::IsFile(const Utf8Path &Path)
+    {
+        u64 tick = armGetSystemTick();
+        bool ex = (this->files.find(this->Normalize(Path)) != this->files.end());
+        this->stats.Record(IoOperation::Stat, tick, 0, false);
+        return ex;
+    }
+
+    bool RamExplorer::IsDirectory(const Utf8Path &Path)
+    {
+        u64 tick = armGetSystemTick();
+        auto path = this->Normalize(Path);
+        bool ex = ((path == this->mntroot) || (this->dirs.find(path) != this->dirs.end()));
+        this->stats.Record(IoOperation::Stat, tick, 0, false);
+        return ex;
+    }
+
+    void RamExplorer::CreateFile(const Utf8Path &Path)
+    {
+        auto path = this->Normalize(Path);
+        if(this->files.find(path) == this->files.end()) this->files[path] = std::vector<u8>();
+    }
+
+    bool RamExplorer::AllocateFile(const Utf8Path &Path, u64 Size)
+    {
+        this->CreateFile(Path);
+        return this->Resize(this->files[this->Normalize(Path)], Size);
+    }
+
+    void RamExplorer::CreateDirectory(const Utf8Path &Path)
+    {
+        this->dirs.insert(this->Normalize(Path));
+    }
+
+    Result RamExplorer::RenameFile(const Utf8Path &Path, const Utf8Path &NewName)
+    {
+        auto path = this->Normalize(Path);
+        auto npath = this->Normalize(NewName);
+        auto file = this->files.find(path);
+        if(file == this->files.end()) return MAKERESULT(err::result::module::Errno, ENOENT);
+        if(this->files.find(npath) != this->files.end()) return err::result::ResultEntryAlreadyPresent;
+        this->files[npath] = std::move(file->second);
+        this->files.erase(path);
+        return 0;
+    }
+
+    Result RamExplorer::RenameDirectory(const Utf8Path &Path, const Utf8Path &NewName)
+    {
+        auto path = this->Normalize(Path);
+        auto npath = this->Normalize(NewName);
+        if(this->dirs.find(path) == this->dirs.end()) return MAKERESULT(err::result::module::Errno, ENOENT);
+        if(this->dirs.find(npath) != this->dirs.end()) return err::result::ResultEntryAlreadyPresent;
+        auto prefix = path + "/";
+        std::set<std::string> ndirs;
+        for(auto &dir: this->dirs)
+        {
+            if(dir == path) ndirs.insert(npath);
+            else if(dir.compare(0, prefix.length(), prefix) == 0) ndirs.insert(npath + dir.substr(path.length()));
+            else ndirs.insert(dir);
+        }
+        this->dirs = std::move(ndirs);
+        std::map<std::string, std::vector<u8>> nfiles;
+        for(auto &file: this->files)
+        {
+            if(file.first.compare(0, prefix.length(), prefix) == 0) nfiles[npath + file.first.substr(path.length())] = std::move(file.second);
+            else nfiles[file.first] = std::move(file.second);
+        }
+        this->files = std::move(nfiles);
+        return 0;
+    }
+
+    void RamExplorer::DeleteFile(const Utf8Path &Path)
+    {
+        auto file = this->files.find(this->Normalize(Path));
+        if(file == this->files.end()) return;
+        this->usedsize -= file->second.size();
+        this->files.erase(file);
+    }
+
+    void RamExplorer::DeleteDirectorySingle(const Utf8Path &Path)
+    {
+        // Like fsdev, this removes everything below the directory too
+        auto path = this->Normalize(Path);
+        auto prefix = path;
+        if(prefix.back() != '/') prefix += "/";
+        for(auto it = this->files.begin(); it != this->files.end();)
+        {
+            if(it->first.compare(0, prefix.length(), prefix) == 0)
+            {
+                this->usedsize -= it->second.size();
+                it = this->files.erase(it);
+            }
+            else it++;
+        }
+        for(auto it = this->dirs.begin(); it != this->dirs.end();)
+        {
+            if((*it == path) || (it->compare(0, prefix.length(), prefix) == 0)) it = this->dirs.erase(it);
+            else it++;
+        }
+    }
+
+    void RamExplorer::StartFile(const Utf8Path &path, FileMode mode)
+    {
+        if(mode == FileMode::Read) return;
+        auto npath = this->Normalize(path);
+        this->CreateFile(npath);
+        auto &data = this->files[npath];
+        this->w_path = npath;
+        this->w_off = 0;
+        if(mode == FileMode::Write) this->Resize(data, 0);
+        else if(mode == FileMode::Append) this->w_off = data.size();
+    }
+
+    u64 RamExplorer::ReadFileBlock(const Utf8Path &Path, u64 Offset, u64 Size, u8 *Out)
+    {
+        u64 tick = armGetSystemTick();
+        u64 rsz = 0;
+        auto file = this->files.find(this->Normalize(Path));
+        if((file != this->files.end()) && (Offset < file->second.size()))
+        {
+            rsz = std::min(Size, file->second.size() - Offset);
+            memcpy(Out, file->second.data() + Offset, rsz);
+        }
+        this->stats.Record(IoOperation::Read, tick, rsz, (rsz == 0) && (Size > 0));
+        return rsz;
+    }
+
+    u64 RamExplorer::WriteFileBlock(const Utf8Path &Path, u8 *Data, u64 Size)
+    {
+        u64 tick = armGetSystemTick();
+        auto path = this->Normalize(Path);
+        // Without an open file, writes append like the other explorers do
+        if(path != this->w_path)
+        {
+            this->CreateFile(path);
+            this->w_path = path;
+            this->w_off = this->files[path].size();
+        }
+        u64 wsz = 0;
+        auto &data = this->files[path];
+        if(((this->w_off + Size) <= data.size()) || this->Resize(data, this->w_off + Size))
+        {
+            memcpy(data.data() + this->w_off, Data, Size);
+            this->w_off += Size;
+            wsz = Size;
+        }
+        this->stats.Record(IoOperation::Write, tick, wsz, wsz < Size);
+        return wsz;
+    }
+
+    void RamExplorer::EndFile(FileMode mode)
+    {
+        if(mode == FileMode::Read) return;
+        this->w_path.clear();
+        this->w_off = 0;
+    }
+
+    void RamExplorer::StartDirectory(const Utf8Path &Path)
+    {
+        this->EndDirectory();
+        auto path = this->Normalize(Path);
+        for(auto &dir: this->ListChildren(path, true)) this->dir_ents.push_back({ dir, true });
+        for(auto &file: this->ListChildren(path, false)) this->dir_ents.push_back({ file, false });
+    }
+
+    u32 RamExplorer::ReadDirectoryBlock(u32 Count, std::vector<DirectoryEntry> &Out)
+    {
+        u32 rcount = 0;
+        while((rcount < Count) && (this->dir_idx < this->dir_ents.size()))
+        {
+            Out.push_back(this->dir_ents[this->dir_idx]);
+            this->dir_idx++;
+            rcount++;
+        }
+        return rcount;
+    }
+
+    void RamExplorer::EndDirectory()
+    {
+        this->dir_ents.clear();
+        this->dir_idx = 0;
+    }
+
+    u64 RamExplorer::GetFileSize(const Utf8Path &Path)
+    {
+        auto file = this->files.find(this->Normalize(Path));
+        if(file == this->files.end()) return 0;
+        return file->second.size();
+    }
+
+    u64 RamExplorer::GetTotalSpace()
+    {
+        return this->maxsize;
+    }
+
+    u64 RamExplorer::GetFreeSpace()
+    {
+        return this->maxsize - this->usedsize;
+    }
+
+    void RamExplorer::SetArchiveBit(const Utf8Path &Path)
+    {
+    }
+}
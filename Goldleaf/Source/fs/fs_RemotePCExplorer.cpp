@@ -31,15 +31,16 @@
 
 namespace fs
 {
-    RemotePCExplorer::RemotePCExplorer(String MountName)
+    RemotePCExplorer::RemotePCExplorer(String MountName) : dir_count(0), file_count(0), dir_idx(0)
     {
         this->SetNames(MountName, MountName);
     }
 
-    std::vector<String> RemotePCExplorer::GetDirectories(String Path)
+    std::vector<String> RemotePCExplorer::GetDirectories(const Utf8Path &Path)
     {
+        u64 tick = armGetSystemTick();
         std::vector<String> dirs;
-        String path = this->MakeFull(Path);
+        String path = this->MakeFullPath(Path).ToString();
         u32 dircount = 0;
         auto rc = usb::ProcessCommand<usb::CommandId::GetDirectoryCount>(usb::InString(path), usb::Out32(dircount));
         if(R_SUCCEEDED(rc))
@@ -51,13 +52,15 @@ namespace fs
                 if(R_SUCCEEDED(rc)) dirs.push_back(dir);
             }
         }
+        this->stats.Record(IoOperation::List, tick, 0, R_FAILED(rc));
         return dirs;
     }
 
-    std::vector<String> RemotePCExplorer::GetFiles(String Path)
+    std::vector<String> RemotePCExplorer::GetFiles(const Utf8Path &Path)
     {
+        u64 tick = armGetSystemTick();
         std::vector<String> files;
-        String path = this->MakeFull(Path);
+        String path = this->MakeFullPath(Path).ToString();
         u32 filecount = 0;
         auto rc = usb::ProcessCommand<usb::CommandId::GetFileCount>(usb::InString(path), usb::Out32(filecount));
         if(R_SUCCEEDED(rc))
@@ -69,97 +72,110 @@ namespace fs
                 if(R_SUCCEEDED(rc)) files.push_back(file);
             }
         }
+        this->stats.Record(IoOperation::List, tick, 0, R_FAILED(rc));
         return files;
     }
 
-    bool RemotePCExplorer::Exists(String Path)
+    bool RemotePCExplorer::Exists(const Utf8Path &Path)
     {
+        u64 tick = armGetSystemTick();
         bool ex = false;
-        String path = this->MakeFull(Path);
+        String path = this->MakeFullPath(Path).ToString();
         u32 type = 0;
         u64 tmpfsz = 0;
-        usb::ProcessCommand<usb::CommandId::StatPath>(usb::InString(path), usb::Out32(type), usb::Out64(tmpfsz));
+        auto rc = usb::ProcessCommand<usb::CommandId::StatPath>(usb::InString(path), usb::Out32(type), usb::Out64(tmpfsz));
         ex = ((type == 1) || (type == 2));
+        this->stats.Record(IoOperation::Stat, tick, 0, R_FAILED(rc));
         return ex;
     }
 
-    bool RemotePCExplorer::IsFile(String Path)
+    bool RemotePCExplorer::IsFile(const Utf8Path &Path)
     {
+        u64 tick = armGetSystemTick();
         bool ex = false;
-        String path = this->MakeFull(Path);
+        String path = this->MakeFullPath(Path).ToString();
         u32 type = 0;
         u64 tmpfsz = 0;
-        usb::ProcessCommand<usb::CommandId::StatPath>(usb::InString(path), usb::Out32(type), usb::Out64(tmpfsz));
+        auto rc = usb::ProcessCommand<usb::CommandId::StatPath>(usb::InString(path), usb::Out32(type), usb::Out64(tmpfsz));
         ex = (type == 1);
+        this->stats.Record(IoOperation::Stat, tick, 0, R_FAILED(rc));
         return ex;
     }
 
-    bool RemotePCExplorer::IsDirectory(String Path)
+    bool RemotePCExplorer::IsDirectory(const Utf8Path &Path)
     {
+        u64 tick = armGetSystemTick();
         bool ex = false;
-        String path = this->MakeFull(Path);
+        String path = this->MakeFullPath(Path).ToString();
         u32 type = 0;
         u64 tmpfsz = 0;
-        usb::ProcessCommand<usb::CommandId::StatPath>(usb::InString(path), usb::Out32(type), usb::Out64(tmpfsz));
+        auto rc = usb::ProcessCommand<usb::CommandId::StatPath>(usb::InString(path), usb::Out32(type), usb::Out64(tmpfsz));
         ex = (type == 2);
+        this->stats.Record(IoOperation::Stat, tick, 0, R_FAILED(rc));
         return ex;
     }
 
-    void RemotePCExplorer::CreateFile(String Path)
+    void RemotePCExplorer::CreateFile(const Utf8Path &Path)
     {
-        String path = this->MakeFull(Path);
+        String path = this->MakeFullPath(Path).ToString();
         usb::ProcessCommand<usb::CommandId::Create>(usb::In32(1), usb::InString(path));
     }
 
-    void RemotePCExplorer::CreateDirectory(String Path)
+    void RemotePCExplorer::CreateDirectory(const Utf8Path &Path)
     {
-        String path = this->MakeFull(Path);
+        String path = this->MakeFullPath(Path).ToString();
         usb::ProcessCommand<usb::CommandId::Create>(usb::In32(2), usb::InString(path));
     }
 
-    void RemotePCExplorer::RenameFile(String Path, String NewName)
+    Result RemotePCExplorer::RenameFile(const Utf8Path &Path, const Utf8Path &NewName)
     {
-        String path = this->MakeFull(Path);
-        usb::ProcessCommand<usb::CommandId::Rename>(usb::In32(1), usb::InString(path), usb::InString(NewName));
+        String path = this->MakeFullPath(Path).ToString();
+        return usb::ProcessCommand<usb::CommandId::Rename>(usb::In32(1), usb::InString(path), usb::InString(NewName.ToString()));
     }
 
-    void RemotePCExplorer::RenameDirectory(String Path, String NewName)
+    Result RemotePCExplorer::RenameDirectory(const Utf8Path &Path, const Utf8Path &NewName)
     {
-        String path = this->MakeFull(Path);
-        usb::ProcessCommand<usb::CommandId::Rename>(usb::In32(2), usb::InString(path), usb::InString(NewName));
+        String path = this->MakeFullPath(Path).ToString();
+        return usb::ProcessCommand<usb::CommandId::Rename>(usb::In32(2), usb::InString(path), usb::InString(NewName.ToString()));
     }
 
-    void RemotePCExplorer::DeleteFile(String Path)
+    void RemotePCExplorer::DeleteFile(const Utf8Path &Path)
     {
-        String path = this->MakeFull(Path);
+        String path = this->MakeFullPath(Path).ToString();
         usb::ProcessCommand<usb::CommandId::Delete>(usb::In32(1), usb::InString(path));
     }
 
-    void RemotePCExplorer::DeleteDirectorySingle(String Path)
+    void RemotePCExplorer::DeleteDirectorySingle(const Utf8Path &Path)
     {
-        String path = this->MakeFull(Path);
+        String path = this->MakeFullPath(Path).ToString();
         usb::ProcessCommand<usb::CommandId::Delete>(usb::In32(2), usb::InString(path));
     }
 
-    void RemotePCExplorer::StartFile(String path, FileMode mode)
+    void RemotePCExplorer::StartFile(const Utf8Path &path, FileMode mode)
     {
-        String npath = this->MakeFull(path);
+        String npath = this->MakeFullPath(path).ToString();
         usb::ProcessCommand<usb::CommandId::StartFile>(usb::InString(npath), usb::In32((u32)mode));
     }
 
-    u64 RemotePCExplorer::ReadFileBlock(String Path, u64 Offset, u64 Size, u8 *Out)
+    u64 RemotePCExplorer::ReadFileBlock(const Utf8Path &Path, u64 Offset, u64 Size, u8 *Out)
     {
+        u64 tick = armGetSystemTick();
         u64 rsize = 0;
-        String path = this->MakeFull(Path);
-        usb::ProcessCommand<usb::CommandId::ReadFile>(usb::InString(path), usb::In64(Offset), usb::In64(Size), usb::Out64(rsize), usb::OutBuffer(Out, Size));
+        String path = this->MakeFullPath(Path).ToString();
+        auto rc = usb::ProcessCommand<usb::CommandId::ReadFile>(usb::InString(path), usb::In64(Offset), usb::In64(Size), usb::Out64(rsize), usb::OutBuffer(Out, Size));
+        this->stats.Record(IoOperation::Read, tick, rsize, R_FAILED(rc));
         return rsize;
     }
 
-    u64 RemotePCExplorer::WriteFileBlock(String Path, u8 *Data, u64 Size)
+    u64 RemotePCExplorer::WriteFileBlock(const Utf8Path &Path, u8 *Data, u64 Size)
     {
-        String path = this->MakeFull(Path);
-        usb::ProcessCommand<usb::CommandId::WriteFile>(usb::InString(path), usb::In64(Size), usb::InBuffer(Data, Size));
-        return Size;
+        u64 tick = armGetSystemTick();
+        String path = this->MakeFullPath(Path).ToString();
+        auto rc = usb::ProcessCommand<usb::CommandId::WriteFile>(usb::InString(path), usb::In64(Size), usb::InBuffer(Data, Size));
+        // Nothing is known to have been written when the command fails
+        u64 wsize = R_SUCCEEDED(rc) ? Size : 0;
+        this->stats.Record(IoOperation::Write, tick, wsize, R_FAILED(rc));
+        return wsize;
     }
 
     void RemotePCExplorer::EndFile(FileMode mode)
@@ -167,12 +183,63 @@ namespace fs
         usb::ProcessCommand<usb::CommandId::EndFile>(usb::In32((u32)mode));
     }
 
-    u64 RemotePCExplorer::GetFileSize(String Path)
+    void RemotePCExplorer::StartDirectory(const Utf8Path &Path)
     {
+        this->dir_path = this->MakeFullPath(Path).ToString();
+        this->dir_count = 0;
+        this->file_count = 0;
+        this->dir_idx = 0;
+        usb::ProcessCommand<usb::CommandId::GetDirectoryCount>(usb::InString(this->dir_path), usb::Out32(this->dir_count));
+        usb::ProcessCommand<usb::CommandId::GetFileCount>(usb::InString(this->dir_path), usb::Out32(this->file_count));
+    }
+
+    u32 RemotePCExplorer::ReadDirectoryBlock(u32 Count, std::vector<DirectoryEntry> &Out)
+    {
+        // The PC side lists directories and files separately, so directories come first
+        u64 tick = armGetSystemTick();
+        u32 rcount = 0;
+        bool failed = false;
+        while((rcount < Count) && (this->dir_idx < (this->dir_count + this->file_count)))
+        {
+            DirectoryEntry ent = {};
+            Result rc = 0;
+            if(this->dir_idx < this->dir_count)
+            {
+                ent.IsDirectory = true;
+                rc = usb::ProcessCommand<usb::CommandId::GetDirectory>(usb::InString(this->dir_path), usb::In32(this->dir_idx), usb::OutString(ent.Name));
+            }
+            else
+            {
+                ent.IsDirectory = false;
+                rc = usb::ProcessCommand<usb::CommandId::GetFile>(usb::InString(this->dir_path), usb::In32(this->dir_idx - this->dir_count), usb::OutString(ent.Name));
+            }
+            this->dir_idx++;
+            if(R_SUCCEEDED(rc))
+            {
+                Out.push_back(ent);
+                rcount++;
+            }
+            else failed = true;
+        }
+        this->stats.Record(IoOperation::List, tick, 0, failed);
+        return rcount;
+    }
+
+    void RemotePCExplorer::EndDirectory()
+    {
+        this->dir_count = 0;
+        this->file_count = 0;
+        this->dir_idx = 0;
+    }
+
+    u64 RemotePCExplorer::GetFileSize(const Utf8Path &Path)
+    {
+        u64 tick = armGetSystemTick();
         u64 sz = 0;
-        String path = this->MakeFull(Path);
+        String path = this->MakeFullPath(Path).ToString();
         u32 tmptype = 0;
-        usb::ProcessCommand<usb::CommandId::StatPath>(usb::InString(path), usb::Out32(tmptype), usb::Out64(sz));
+        auto rc = usb::ProcessCommand<usb::CommandId::StatPath>(usb::InString(path), usb::Out32(tmptype), usb::Out64(sz));
+        this->stats.Record(IoOperation::Stat, tick, 0, R_FAILED(rc));
         return sz;
     }
 
@@ -202,7 +269,7 @@ namespace fs
         return sz;
     }
 
-    void RemotePCExplorer::SetArchiveBit(String Path)
+    void RemotePCExplorer::SetArchiveBit(const Utf8Path &Path)
     {
         // Non-HOS operating systems don't handle archive bit for what we want, so :P
     }
@@ -0,0 +1,128 @@
+
+/*
+
+    Goldleaf - Multipurpose homebrew tool for Nintendo Switch
+    Copyright (C) 2018-2019  XorTroll
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+#include <fs/fs_FileSystem.hpp>
+#include <fstream>
+#include <iomanip>
+
+namespace fs
+{
+    IoStats::IoStats()
+    {
+        this->Reset();
+    }
+
+    void IoStats::Record(IoOperation Op, u64 StartTick, u64 Bytes, bool Error)
+    {
+        u64 us = armTicksToNs(armGetSystemTick() - StartTick) / 1000;
+        u32 bucket = 0;
+        while((bucket < (LatencyBucketCount - 1)) && (us >> bucket)) bucket++;
+        auto &stats = this->ops[static_cast<u32>(Op)];
+        // Counters are independent of each other, so relaxed ordering is enough
+        stats.Ops.fetch_add(1, std::memory_order_relaxed);
+        stats.Bytes.fetch_add(Bytes, std::memory_order_relaxed);
+        if(Error) stats.Errors.fetch_add(1, std::memory_order_relaxed);
+        stats.TotalMicros.fetch_add(us, std::memory_order_relaxed);
+        stats.Latency[bucket].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    u64 IoStats::GetOps(IoOperation Op)
+    {
+        return this->ops[static_cast<u32>(Op)].Ops.load(std::memory_order_relaxed);
+    }
+
+    u64 IoStats::GetBytes(IoOperation Op)
+    {
+        return this->ops[static_cast<u32>(Op)].Bytes.load(std::memory_order_relaxed);
+    }
+
+    u64 IoStats::GetErrors(IoOperation Op)
+    {
+        return this->ops[static_cast<u32>(Op)].Errors.load(std::memory_order_relaxed);
+    }
+
+    u64 IoStats::GetTotalMicros(IoOperation Op)
+    {
+        return this->ops[static_cast<u32>(Op)].TotalMicros.load(std::memory_order_relaxed);
+    }
+
+    std::vector<u64> IoStats::GetLatencyHistogram(IoOperation Op)
+    {
+        std::vector<u64> hist;
+        for(auto &bucket: this->ops[static_cast<u32>(Op)].Latency) hist.push_back(bucket.load(std::memory_order_relaxed));
+        return hist;
+    }
+
+    void IoStats::Reset()
+    {
+        for(auto &stats: this->ops)
+        {
+            stats.Ops = 0;
+            stats.Bytes = 0;
+            stats.Errors = 0;
+            stats.TotalMicros = 0;
+            for(auto &bucket: stats.Latency) bucket = 0;
+        }
+    }
+
+    JSON IoStats::ToJSON()
+    {
+        auto json = JSON::object();
+        for(u32 i = 0; i < static_cast<u32>(IoOperation::Count); i++)
+        {
+            auto op = static_cast<IoOperation>(i);
+            auto opjson = JSON::object();
+            opjson["ops"] = this->GetOps(op);
+            opjson["bytes"] = this->GetBytes(op);
+            opjson["errors"] = this->GetErrors(op);
+            opjson["totalUs"] = this->GetTotalMicros(op);
+            opjson["latencyLog2Us"] = this->GetLatencyHistogram(op);
+            json[IoOperationToString(op).AsUTF8()] = opjson;
+        }
+        return json;
+    }
+
+    String IoOperationToString(IoOperation Op)
+    {
+        switch(Op)
+        {
+            case IoOperation::Read:
+                return "read";
+            case IoOperation::Write:
+                return "write";
+            case IoOperation::Stat:
+                return "stat";
+            case IoOperation::List:
+                return "list";
+            default:
+                return "";
+        }
+    }
+
+    void SaveIoStats()
+    {
+        auto json = JSON::object();
+        for(auto exp: GetLoadedExplorers()) json[exp->GetMountName().AsUTF8()] = exp->GetStats().ToJSON();
+        std::ofstream ofs("sdmc:/" + consts::Root + "/iostats.json");
+        ofs << std::setw(4) << json;
+        ofs.close();
+    }
+}
@@ -20,7 +20,9 @@
 */
 
 #include <fs/fs_StdExplorer.hpp>
+#include <err/err_Result.hpp>
 #include <sys/stat.h>
+#include <unistd.h>
 #include <dirent.h>
 #include <malloc.h>
 #include <fstream>
@@ -30,15 +32,16 @@
 
 namespace fs
 {
-    StdExplorer::StdExplorer() : r_file_obj(NULL), w_file_obj(NULL)
+    StdExplorer::StdExplorer() : r_file_obj(NULL), w_file_obj(NULL), dir_obj(NULL)
     {
     }
 
-    std::vector<String> StdExplorer::GetDirectories(String Path)
+    std::vector<String> StdExplorer::GetDirectories(const Utf8Path &Path)
     {
+        u64 tick = armGetSystemTick();
         std::vector<String> dirs;
-        String path = this->MakeFull(Path);
-        DIR *dp = opendir(path.AsUTF8().c_str());
+        auto path = this->MakeFullPath(Path);
+        DIR *dp = opendir(path.CStr());
         if(dp)
         {
             struct dirent *dt;
@@ -46,19 +49,25 @@ namespace fs
             {
                 dt = readdir(dp);
                 if(dt == NULL) break;
-                std::string ent = dt->d_name;
-                if(this->IsDirectory(path + "/" + ent)) dirs.push_back(ent);
+                if(dt->d_type == DT_DIR) dirs.push_back(std::string(dt->d_name));
+                else if(dt->d_type == DT_UNKNOWN)
+                {
+                    struct stat st;
+                    if((stat(path.Join(dt->d_name).CStr(), &st) == 0) && (st.st_mode & S_IFDIR)) dirs.push_back(std::string(dt->d_name));
+                }
             }
             closedir(dp);
         }
+        this->stats.Record(IoOperation::List, tick, 0, dp == NULL);
         return dirs;
     }
 
-    std::vector<String> StdExplorer::GetFiles(String Path)
+    std::vector<String> StdExplorer::GetFiles(const Utf8Path &Path)
     {
+        u64 tick = armGetSystemTick();
         std::vector<String> files;
-        String path = this->MakeFull(Path);
-        DIR *dp = opendir(path.AsUTF8().c_str());
+        auto path = this->MakeFullPath(Path);
+        DIR *dp = opendir(path.CStr());
         if(dp)
         {
             struct dirent *dt;
@@ -66,72 +75,98 @@ namespace fs
             {
                 dt = readdir(dp);
                 if(dt == NULL) break;
-                std::string ent = dt->d_name;
-                if(this->IsFile(path + "/" + ent)) files.push_back(ent);
+                if(dt->d_type == DT_REG) files.push_back(std::string(dt->d_name));
+                else if(dt->d_type == DT_UNKNOWN)
+                {
+                    struct stat st;
+                    if((stat(path.Join(dt->d_name).CStr(), &st) == 0) && (st.st_mode & S_IFREG)) files.push_back(std::string(dt->d_name));
+                }
             }
             closedir(dp);
         }
+        this->stats.Record(IoOperation::List, tick, 0, dp == NULL);
         return files;
     }
 
-    bool StdExplorer::Exists(String Path)
+    bool StdExplorer::Exists(const Utf8Path &Path)
     {
-        String path = this->MakeFull(Path);
+        u64 tick = armGetSystemTick();
+        auto path = this->MakeFullPath(Path);
         struct stat st;
-        return (stat(path.AsUTF8().c_str(), &st) == 0);
+        bool ex = (stat(path.CStr(), &st) == 0);
+        this->stats.Record(IoOperation::Stat, tick, 0, false);
+        return ex;
     }
 
-    bool StdExplorer::IsFile(String Path)
+    bool StdExplorer::IsFile(const Utf8Path &Path)
     {
-        String path = this->MakeFull(Path);
+        u64 tick = armGetSystemTick();
+        auto path = this->MakeFullPath(Path);
         struct stat st;
-        return ((stat(path.AsUTF8().c_str(), &st) == 0) && (st.st_mode & S_IFREG));
+        bool ex = ((stat(path.CStr(), &st) == 0) && (st.st_mode & S_IFREG));
+        this->stats.Record(IoOperation::Stat, tick, 0, false);
+        return ex;
     }
 
-    bool StdExplorer::IsDirectory(String Path)
+    bool StdExplorer::IsDirectory(const Utf8Path &Path)
     {
-        String path = this->MakeFull(Path);
+        u64 tick = armGetSystemTick();
+        auto path = this->MakeFullPath(Path);
         struct stat st;
-        return ((stat(path.AsUTF8().c_str(), &st) == 0) && (st.st_mode & S_IFDIR));
+        bool ex = ((stat(path.CStr(), &st) == 0) && (st.st_mode & S_IFDIR));
+        this->stats.Record(IoOperation::Stat, tick, 0, false);
+        return ex;
     }
     
-    void StdExplorer::CreateFile(String Path)
+    void StdExplorer::CreateFile(const Utf8Path &Path)
     {
-        String path = this->MakeFull(Path);
-        fsdevCreateFile(Path.AsUTF8().c_str(), 0, 0);
+        auto path = this->MakeFullPath(Path);
+        fsdevCreateFile(path.CStr(), 0, 0);
     }
 
-    void StdExplorer::CreateDirectory(String Path)
+    bool StdExplorer::AllocateFile(const Utf8Path &Path, u64 Size)
     {
-        String path = this->MakeFull(Path);
-        mkdir(path.AsUTF8().c_str(), 777);
+        auto path = this->MakeFullPath(Path);
+        struct stat st;
+        if((stat(path.CStr(), &st) == 0) && (st.st_mode & S_IFREG)) return (truncate(path.CStr(), Size) == 0);
+        // FAT32 can't hold files of 4GB or more, those need to be concatenation files
+        u32 opts = (Size >= Size4GB) ? FsCreateOption_BigFile : 0;
+        return (fsdevCreateFile(path.CStr(), Size, opts) == 0);
+    }
+
+    void StdExplorer::CreateDirectory(const Utf8Path &Path)
+    {
+        auto path = this->MakeFullPath(Path);
+        mkdir(path.CStr(), 777);
     }
 
-    void StdExplorer::RenameFile(String Path, String NewName)
+    Result StdExplorer::RenameFile(const Utf8Path &Path, const Utf8Path &NewName)
     {
-        String path = this->MakeFull(Path);
-        String npath = this->MakeFull(NewName);
-        rename(path.AsUTF8().c_str(), npath.AsUTF8().c_str());
+        auto path = this->MakeFullPath(Path);
+        auto npath = this->MakeFullPath(NewName);
+        // fsdev fails (EEXIST) instead of replacing an existing destination
+        if(rename(path.CStr(), npath.CStr()) != 0) return err::result::MakeErrnoResult();
+        return 0;
     }
 
-    void StdExplorer::RenameDirectory(String Path, String NewName)
+    Result StdExplorer::RenameDirectory(const Utf8Path &Path, const Utf8Path &NewName)
     {
         return this->RenameFile(Path, NewName);
     }
 
-    void StdExplorer::DeleteFile(String Path)
+    void StdExplorer::DeleteFile(const Utf8Path &Path)
     {
-        String path = this->MakeFull(Path);
-        remove(path.AsUTF8().c_str());
+        auto path = this->MakeFullPath(Path);
+        remove(path.CStr());
     }
 
-    void StdExplorer::DeleteDirectorySingle(String Path)
+    void StdExplorer::DeleteDirectorySingle(const Utf8Path &Path)
     {
-        String path = this->MakeFull(Path);
-        fsdevDeleteDirectoryRecursively(path.AsUTF8().c_str());
+        auto path = this->MakeFullPath(Path);
+        fsdevDeleteDirectoryRecursively(path.CStr());
     }
 
-    void StdExplorer::StartFile(String path, FileMode mode)
+    void StdExplorer::StartFile(const Utf8Path &path, FileMode mode)
     {
         auto fmode = "rw";
         switch(mode)
@@ -145,54 +180,64 @@ namespace fs
             case FileMode::Append:
                 fmode = "ab+";
                 break;
+            case FileMode::Update:
+                fmode = "rb+";
+                break;
         }
         this->EndFile(mode);
-        String npath = this->MakeFull(path);
-        if(mode == FileMode::Read) this->r_file_obj = fopen(npath.AsUTF8().c_str(), fmode);
-        else this->w_file_obj = fopen(npath.AsUTF8().c_str(), fmode);
+        auto npath = this->MakeFullPath(path);
+        if(mode == FileMode::Read)
+        {
+            std::lock_guard<std::mutex> lk(this->r_file_lock);
+            this->r_file_obj = fopen(npath.CStr(), fmode);
+            this->r_file_path = npath.Str();
+        }
+        else this->w_file_obj = fopen(npath.CStr(), fmode);
     }
 
-    u64 StdExplorer::ReadFileBlock(String Path, u64 Offset, u64 Size, u8 *Out)
+    u64 StdExplorer::ReadFileBlock(const Utf8Path &Path, u64 Offset, u64 Size, u8 *Out)
     {
+        u64 tick = armGetSystemTick();
         u64 rsz = 0;
-
-        if(this->r_file_obj != NULL)
+        auto path = this->MakeFullPath(Path);
+        std::unique_lock<std::mutex> lk(this->r_file_lock);
+        if((this->r_file_obj != NULL) && (this->r_file_path == path.Str()))
         {
             fseek(this->r_file_obj, Offset, SEEK_SET);
             rsz = fread(Out, 1, Size, this->r_file_obj);
-            return rsz;
         }
-
-        String path = this->MakeFull(Path);
-        FILE *f = fopen(path.AsUTF8().c_str(), "rb");
-        if(f)
+        else
         {
-            fseek(f, Offset, SEEK_SET);
-            rsz = fread(Out, 1, Size, f);
-            fclose(f);
+            lk.unlock();
+            FILE *f = fopen(path.CStr(), "rb");
+            if(f)
+            {
+                fseek(f, Offset, SEEK_SET);
+                rsz = fread(Out, 1, Size, f);
+                fclose(f);
+            }
         }
+        this->stats.Record(IoOperation::Read, tick, rsz, (rsz == 0) && (Size > 0));
         return rsz;
     }
 
-    u64 StdExplorer::WriteFileBlock(String Path, u8 *Data, u64 Size)
+    u64 StdExplorer::WriteFileBlock(const Utf8Path &Path, u8 *Data, u64 Size)
     {
+        u64 tick = armGetSystemTick();
         u64 wsz = 0;
-        
-
-        if(this->w_file_obj != NULL)
-        {
-            wsz = fwrite(Data, 1, Size, this->w_file_obj);
-            return wsz;
-        }
-
-        String path = this->MakeFull(Path);
 
-        FILE *f = fopen(path.AsUTF8().c_str(), "ab+");
-        if(f)
+        if(this->w_file_obj != NULL) wsz = fwrite(Data, 1, Size, this->w_file_obj);
+        else
         {
-            wsz = fwrite(Data, 1, Size, f);
-            fclose(f);
+            auto path = this->MakeFullPath(Path);
+            FILE *f = fopen(path.CStr(), "ab+");
+            if(f)
+            {
+                wsz = fwrite(Data, 1, Size, f);
+                fclose(f);
+            }
         }
+        this->stats.Record(IoOperation::Write, tick, wsz, wsz < Size);
         return wsz;
     }
 
@@ -200,10 +245,12 @@ namespace fs
     {
         if(mode == FileMode::Read)
         {
+            std::lock_guard<std::mutex> lk(this->r_file_lock);
             if(this->r_file_obj != NULL)
             {
                 fclose(this->r_file_obj);
                 this->r_file_obj = NULL;
+                this->r_file_path.clear();
             }
         }
         else
@@ -216,15 +263,88 @@ namespace fs
         }
     }
 
-    u64 StdExplorer::GetFileSize(String Path)
+    void StdExplorer::StartDirectory(const Utf8Path &Path)
+    {
+        this->EndDirectory();
+        this->dir_path = this->MakeFullPath(Path);
+        this->dir_obj = opendir(this->dir_path.CStr());
+    }
+
+    u32 StdExplorer::ReadDirectoryBlock(u32 Count, std::vector<DirectoryEntry> &Out)
+    {
+        u32 rcount = 0;
+        if(this->dir_obj == NULL) return rcount;
+        u64 tick = armGetSystemTick();
+        while(rcount < Count)
+        {
+            struct dirent *dt = readdir(this->dir_obj);
+            if(dt == NULL) break;
+            DirectoryEntry ent = {};
+            ent.Name = std::string(dt->d_name);
+            // fsdev already reports the entry type, so only stat when it couldn't
+            if(dt->d_type == DT_DIR) ent.IsDirectory = true;
+            else if(dt->d_type == DT_REG) ent.IsDirectory = false;
+            else
+            {
+                struct stat st;
+                ent.IsDirectory = ((stat(this->dir_path.Join(dt->d_name).CStr(), &st) == 0) && (st.st_mode & S_IFDIR));
+            }
+            Out.push_back(ent);
+            rcount++;
+        }
+        this->stats.Record(IoOperation::List, tick, 0, false);
+        return rcount;
+    }
+
+    void StdExplorer::EndDirectory()
     {
+        if(this->dir_obj != NULL)
+        {
+            closedir(this->dir_obj);
+            this->dir_obj = NULL;
+        }
+    }
+
+    u64 StdExplorer::GetFileSize(const Utf8Path &Path)
+    {
+        u64 tick = armGetSystemTick();
         u64 sz = 0;
-        String path = this->MakeFull(Path);
+        auto path = this->MakeFullPath(Path);
         struct stat st;
-        if(stat(path.AsUTF8().c_str(), &st) == 0) sz = st.st_size;
+        bool ok = (stat(path.CStr(), &st) == 0);
+        if(ok) sz = st.st_size;
+        this->stats.Record(IoOperation::Stat, tick, 0, !ok);
         return sz;
     }
 
+    u64 StdExplorer::GetModifiedTime(const Utf8Path &Path)
+    {
+        u64 tick = armGetSystemTick();
+        u64 mtime = 0;
+        auto path = this->MakeFullPath(Path);
+        struct stat st;
+        bool ok = (stat(path.CStr(), &st) == 0);
+        if(ok) mtime = st.st_mtime;
+        this->stats.Record(IoOperation::Stat, tick, 0, !ok);
+        return mtime;
+    }
+
+    void StdExplorer::GetFileInfo(const Utf8Path &Path, u64 &Size, u64 &ModifiedTime)
+    {
+        u64 tick = armGetSystemTick();
+        Size = 0;
+        ModifiedTime = 0;
+        auto path = this->MakeFullPath(Path);
+        struct stat st;
+        bool ok = (stat(path.CStr(), &st) == 0);
+        if(ok)
+        {
+            Size = st.st_size;
+            ModifiedTime = st.st_mtime;
+        }
+        this->stats.Record(IoOperation::Stat, tick, 0, !ok);
+    }
+
     u64 StdExplorer::GetTotalSpace()
     {
         return 0;
@@ -235,9 +355,9 @@ namespace fs
         return 0;
     }
 
-    void StdExplorer::SetArchiveBit(String Path)
+    void StdExplorer::SetArchiveBit(const Utf8Path &Path)
     {
-        String path = this->MakeFull(Path);
-        fsdevSetConcatenationFileAttribute(path.AsUTF8().c_str());
+        auto path = this->MakeFullPath(Path);
+        fsdevSetConcatenationFileAttribute(path.CStr());
     }
 }
\ No newline at end of file
@@ -167,12 +167,13 @@ namespace hos
     void PayloadProcess(String Path)
     {
         u8 *block = new (std::align_val_t(0x1000)) u8[MaxPayloadSize]();
-        auto fexp = fs::GetExplorerForMountName(fs::GetPathRoot(Path));
-        auto size = fexp->GetFileSize(Path);
+        fs::Utf8Path path(Path);
+        auto fexp = fs::GetExplorerForPath(path);
+        auto size = fexp->GetFileSize(path);
         if((size == 0) || (size > MaxPayloadSize)) return;
         
-        fexp->StartFile(Path, fs::FileMode::Read);
-        fexp->ReadFileBlock(Path, 0, size, block);
+        fexp->StartFile(path, fs::FileMode::Read);
+        fexp->ReadFileBlock(path, 0, size, block);
         fexp->EndFile(fs::FileMode::Read);
 
         IRAMClear();
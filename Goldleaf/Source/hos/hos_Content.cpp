@@ -62,10 +62,10 @@ namespace hos
                 auto fs = fwfs.GetContents();
                 for(auto &f: fs)
                 {
-                    u32 rawver = 0;
-                    fwfs.StartFile(f, fs::FileMode::Read);
-                    fwfs.ReadFileBlock(f, 8, sizeof(u32), (u8*)&rawver);
-                    fwfs.EndFile(fs::FileMode::Read);
+                    auto view = fwfs.OpenView(f);
+                    auto rrawver = view.GetAs<u32>(8);
+                    if(rrawver == NULL) continue;
+                    u32 rawver = *rrawver;
                     out->Major = (u8)((rawver >> 26) & 0x3f);
                     out->Minor = (u8)((rawver >> 20) & 0x3f);
                     out->Micro = (u8)((rawver >> 16) & 0x3f);
@@ -25,6 +25,7 @@
 #include <fstream>
 #include <sstream>
 #include <iomanip>
+#include <cstring>
 #include <sys/stat.h>
 #include <dirent.h>
 
@@ -433,12 +434,13 @@ namespace hos
 
     TicketData ReadTicket(String Path)
     {
-        auto fexp = fs::GetExplorerForMountName(fs::GetPathRoot(Path));
+        auto fexp = fs::GetExplorerForPath(Path);
         TicketData tik;
+        auto view = fexp->OpenView(Path);
         u64 off = 0;
         u32 tiksig = 0;
-        fexp->StartFile(Path, fs::FileMode::Read);
-        fexp->ReadFileBlock(Path, off, sizeof(u32), (u8*)&tiksig);
+        auto rtiksig = view.GetAs<u32>(off);
+        if(rtiksig != NULL) tiksig = *rtiksig;
         tik.Signature = static_cast<TicketSignature>(tiksig);
         u32 sigsz = 0;
         u32 padsz = 0;
@@ -472,15 +474,16 @@ namespace hos
         u32 tikdata = (4 + sigsz + padsz);
         off = tikdata + 0x40;
         u8 tkey[0x10] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
-        fexp->ReadFileBlock(Path, off, 0x10, tkey);
+        auto rtkey = view.Get(off, 0x10);
+        if(rtkey != NULL) memcpy(tkey, rtkey, 0x10);
         std::stringstream strm;
         strm << std::uppercase << std::setfill('0') << std::hex;
         for(u32 i = 0; i < 0x10; i++) strm << (u32)tkey[i];
         tik.TitleKey = strm.str();
         off = tikdata + 0x160 + 0xf;
         u8 kgen = 0;
-        fexp->ReadFileBlock(Path, off, 1, &kgen);
-        fexp->EndFile(fs::FileMode::Read);
+        auto rkgen = view.Get(off, 1);
+        if(rkgen != NULL) kgen = *rkgen;
         tik.KeyGeneration = kgen;
         return tik;
     }
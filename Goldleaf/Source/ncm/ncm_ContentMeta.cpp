@@ -56,13 +56,20 @@ namespace ncm
 
     std::vector<ContentRecord> ContentMeta::GetContentRecords()
     {
-        ContentMetaHeader contentMetaHeader = this->GetContentMetaHeader();
         std::vector<ContentRecord> contentRecords;
+        for(auto &hashedContentRecord : this->GetHashedContentRecords()) contentRecords.push_back(hashedContentRecord.Record);
+        return contentRecords;
+    }
+
+    std::vector<HashedContentRecord> ContentMeta::GetHashedContentRecords()
+    {
+        ContentMetaHeader contentMetaHeader = this->GetContentMetaHeader();
+        std::vector<HashedContentRecord> contentRecords;
         HashedContentRecord *hashedContentRecords = (HashedContentRecord*)(buf.GetData() + sizeof(ContentMetaHeader) + contentMetaHeader.ExtendedHeaderSize);
         for(u32 i = 0; i < contentMetaHeader.ContentCount; i++)
         {
             HashedContentRecord hashedContentRecord = hashedContentRecords[i];
-            if(static_cast<u8>(hashedContentRecord.Record.Type) <= 5) contentRecords.push_back(hashedContentRecord.Record); 
+            if(static_cast<u8>(hashedContentRecord.Record.Type) <= 5) contentRecords.push_back(hashedContentRecord); 
         }
         return contentRecords;
     }
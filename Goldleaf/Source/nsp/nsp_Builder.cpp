@@ -29,10 +29,12 @@
 
 namespace nsp
 {
-    bool GenerateFrom(String Input, String Out, std::function<void(u64, u64)> Callback)
+    bool GenerateFrom(String Input, String Out, std::function<void(u64, u64)> Callback, fs::Hasher *Hash)
     {
-        auto exp = fs::GetExplorerForPath(Input);
-        auto files = exp->GetFiles(Input);
+        fs::Utf8Path input(Input);
+        fs::Utf8Path out(Out);
+        auto exp = fs::GetExplorerForPath(input);
+        auto files = exp->GetFiles(input);
         PFS0Header header = {};
         header.FileCount = (u32)files.size();
         header.Magic = Magic;
@@ -45,7 +47,7 @@ namespace nsp
             PFS0File entry = {};
             entry.Entry.Offset = base_offset;
             entry.Entry.StringTableOffset = strtablesize;
-            auto fsize = exp->GetFileSize(Input + "/" + file);
+            auto fsize = exp->GetFileSize(input.Join(file.AsUTF8()));
             entry.Entry.Size = fsize;
             entry.Name = file;
             base_offset += fsize;
@@ -55,14 +57,19 @@ namespace nsp
         }
         strtablesize = (strtablesize + 0x1f) &~ 0x1f;
         header.StringTableSize = strtablesize;
-        auto outexp = fs::GetExplorerForPath(Out);
-        outexp->StartFile(Out, fs::FileMode::Write);
-        outexp->WriteFileBlock(Out, (u8*)&header, sizeof(PFS0Header));
+        auto outexp = fs::GetExplorerForPath(out);
+        u64 outsize = sizeof(PFS0Header) + (sizeof(PFS0FileEntry) * fentries.size()) + strtablesize + base_offset;
+        auto wmode = outexp->AllocateFile(out, outsize) ? fs::FileMode::Update : fs::FileMode::Write;
+        outexp->StartFile(out, wmode);
+        outexp->WriteFileBlock(out, (u8*)&header, sizeof(PFS0Header));
+        if(Hash != NULL) Hash->Update(&header, sizeof(PFS0Header));
         for(auto &entry: fentries)
         {
-            outexp->WriteFileBlock(Out, (u8*)&entry.Entry, sizeof(PFS0FileEntry));
+            outexp->WriteFileBlock(out, (u8*)&entry.Entry, sizeof(PFS0FileEntry));
+            if(Hash != NULL) Hash->Update(&entry.Entry, sizeof(PFS0FileEntry));
         }
-        outexp->WriteFileBlock(Out, strtable, strtablesize);
+        outexp->WriteFileBlock(out, strtable, strtablesize);
+        if(Hash != NULL) Hash->Update(strtable, strtablesize);
         size_t done = 0;
         for(auto &entry: fentries)
         {
@@ -70,12 +77,13 @@ namespace nsp
             u8 *buf = fs::GetFileSystemOperationsBuffer();
             size_t readsz = fs::GetFileSystemOperationsBufferSize();
             size_t fdone = 0;
-            auto fentry = Input + "/" + entry.Name;
+            auto fentry = input.Join(entry.Name.AsUTF8());
             exp->StartFile(fentry, fs::FileMode::Read);
             while(toread)
             {
                 auto read = exp->ReadFileBlock(fentry, fdone, std::min(toread, readsz), buf);
-                outexp->WriteFileBlock(Out, buf, read);
+                outexp->WriteFileBlock(out, buf, read);
+                if(Hash != NULL) Hash->Update(buf, read);
                 fdone += read;
                 done += read;
                 toread -= read;
@@ -83,7 +91,7 @@ namespace nsp
             }
             exp->EndFile(fs::FileMode::Read);
         }
-        outexp->EndFile(fs::FileMode::Write);
+        outexp->EndFile(wmode);
         return true;
     }
 }
\ No newline at end of file
@@ -0,0 +1,161 @@
+
+/*
+
+    Goldleaf - Multipurpose homebrew tool for Nintendo Switch
+    Copyright (C) 2018-2019  XorTroll
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+#include <nsp/nsp_ContentSource.hpp>
+#include <cstring>
+#include <algorithm>
+
+namespace nsp
+{
+    static std::string LowerName(std::string Name)
+    {
+        for(auto &c: Name) if((c >= 'A') && (c <= 'Z')) c += ('a' - 'A');
+        return Name;
+    }
+
+    ContentSource::ContentSource(fs::Explorer *Exp, String Path) : path(Path), gexp(Exp), ok(false)
+    {
+    }
+
+    ContentSource::~ContentSource()
+    {
+    }
+
+    bool ContentSource::LoadPartition(u64 Offset, u32 PartitionMagic, u64 EntrySize)
+    {
+        // PFS0 and HFS0 share the layout, only their entries' size differs.
+        // The header, entry table and string table are contiguous: read a first block, then whatever is left of them at once
+        std::vector<u8> meta(PFS0InitialReadSize);
+        u64 rsz = this->gexp->ReadFileBlock(this->path, Offset, PFS0InitialReadSize, meta.data());
+        if(rsz < sizeof(PFS0Header)) return false;
+        PFS0Header header = {};
+        memcpy(&header, meta.data(), sizeof(PFS0Header));
+        if(header.Magic != PartitionMagic) return false;
+        u64 strtoff = sizeof(PFS0Header) + (EntrySize * (u64)header.FileCount);
+        u64 metasize = strtoff + header.StringTableSize;
+        if(metasize > PFS0MaxHeaderSize) return false;
+        meta.resize(std::max(metasize, rsz));
+        if(metasize > rsz)
+        {
+            u64 remsize = metasize - rsz;
+            if(this->gexp->ReadFileBlock(this->path, Offset + rsz, remsize, meta.data() + rsz) != remsize) return false;
+        }
+        auto strtable = (const char*)meta.data() + strtoff;
+        this->files.reserve(header.FileCount);
+        for(u32 i = 0; i < header.FileCount; i++)
+        {
+            // Both entry kinds start with offset, size and name offset
+            PFS0FileEntry entry = {};
+            memcpy(&entry, meta.data() + sizeof(PFS0Header) + (i * EntrySize), sizeof(PFS0FileEntry));
+            SourceFile fl = { "", Offset + metasize + entry.Offset, entry.Size };
+            if(entry.StringTableOffset < header.StringTableSize)
+            {
+                auto name = strtable + entry.StringTableOffset;
+                fl.Name = std::string(name, strnlen(name, header.StringTableSize - entry.StringTableOffset));
+            }
+            this->nameidx.emplace(LowerName(fl.Name.AsUTF8()), i);
+            this->files.push_back(fl);
+        }
+        return true;
+    }
+
+    u32 ContentSource::GetCount()
+    {
+        return this->files.size();
+    }
+
+    String ContentSource::GetFile(u32 Index)
+    {
+        if(Index >= this->files.size()) return "";
+        return this->files[Index].Name;
+    }
+
+    fs::Utf8Path ContentSource::GetPath()
+    {
+        return this->path;
+    }
+
+    u64 ContentSource::ReadFromFile(u32 Index, u64 Offset, u64 Size, u8 *Out)
+    {
+        return this->gexp->ReadFileBlock(this->path, (this->files[Index].Offset + Offset), Size, Out);
+    }
+
+    std::vector<String> ContentSource::GetFiles()
+    {
+        std::vector<String> pfiles;
+        for(auto &file: this->files) pfiles.push_back(file.Name);
+        return pfiles;
+    }
+
+    bool ContentSource::IsOk()
+    {
+        return this->ok;
+    }
+
+    fs::Explorer *ContentSource::GetExplorer()
+    {
+        return this->gexp;
+    }
+
+    u64 ContentSource::GetFileSize(u32 Index)
+    {
+        if(Index >= this->files.size()) return 0;
+        return this->files[Index].Size;
+    }
+
+    u64 ContentSource::GetFileOffset(u32 Index)
+    {
+        if(Index >= this->files.size()) return 0;
+        return this->files[Index].Offset;
+    }
+
+    void ContentSource::SaveFile(u32 Index, fs::Explorer *Exp, String Path)
+    {
+        if(Index >= this->files.size()) return;
+        u64 fsize = this->GetFileSize(Index);
+        u64 rsize = fs::GetFileSystemOperationsBufferSize();
+        u8 *bdata = fs::GetFileSystemOperationsBuffer();
+        u64 szrem = fsize;
+        u64 off = 0;
+        Exp->DeleteFile(Path);
+        Exp->CreateFile(Path);
+        this->gexp->StartFile(this->path, fs::FileMode::Read);
+        Exp->StartFile(Path, fs::FileMode::Write);
+        while(szrem)
+        {
+            u64 tread = std::min(rsize, szrem);
+            u64 rbytes = this->ReadFromFile(Index, off, tread, bdata);
+            Exp->WriteFileBlock(Path, bdata, rbytes);
+            off += rbytes;
+            szrem -= rbytes;
+        }
+        this->gexp->EndFile(fs::FileMode::Read);
+        Exp->EndFile(fs::FileMode::Write);
+    }
+
+    std::optional<u32> ContentSource::GetFileIndexByName(String File)
+    {
+        auto it = this->nameidx.find(LowerName(File.AsUTF8()));
+        if(it == this->nameidx.end()) return std::nullopt;
+        return it->second;
+    }
+}
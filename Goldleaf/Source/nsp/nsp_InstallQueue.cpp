@@ -0,0 +1,100 @@
+
+/*
+
+    Goldleaf - Multipurpose homebrew tool for Nintendo Switch
+    Copyright (C) 2018-2019  XorTroll
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+#include <nsp/nsp_InstallQueue.hpp>
+#include <numeric>
+#include <algorithm>
+
+namespace nsp
+{
+    InstallQueue::InstallQueue(std::vector<String> Paths, fs::Explorer *Exp, Storage Location, u32 Lookahead) : paths(Paths), exp(Exp), location(Location), lookahead(Lookahead), next(0), taken(0), stop(false)
+    {
+        for(auto &path: this->paths) this->sizes.push_back(this->exp->GetFileSize(path));
+        this->insts.resize(this->paths.size());
+    }
+
+    InstallQueue::~InstallQueue()
+    {
+        this->StopPrefetch();
+    }
+
+    u32 InstallQueue::GetCount()
+    {
+        return this->paths.size();
+    }
+
+    String InstallQueue::GetPath(u32 Index)
+    {
+        return this->paths[Index];
+    }
+
+    u64 InstallQueue::GetPackageSize(u32 Index)
+    {
+        return this->sizes[Index];
+    }
+
+    u64 InstallQueue::GetTotalSize()
+    {
+        return std::accumulate(this->sizes.begin(), this->sizes.end(), (u64)0);
+    }
+
+    u64 InstallQueue::GetSizeBefore(u32 Index)
+    {
+        return std::accumulate(this->sizes.begin(), this->sizes.begin() + std::min((size_t)Index, this->sizes.size()), (u64)0);
+    }
+
+    std::unique_ptr<Installer> InstallQueue::Take(u32 Index)
+    {
+        this->StopPrefetch();
+        this->taken = Index + 1;
+        if(this->next <= Index) this->next = Index + 1;
+        // Not read ahead yet (first package, or the previous one was too quick), so it gets prepared as usual
+        if(!this->insts[Index]) return std::make_unique<Installer>(this->paths[Index], this->exp, this->location);
+        return std::move(this->insts[Index]);
+    }
+
+    void InstallQueue::StartPrefetch()
+    {
+        this->StopPrefetch();
+        if(this->next >= this->paths.size()) return;
+        this->stop = false;
+        this->worker = std::thread(&InstallQueue::PrefetchMain, this);
+    }
+
+    void InstallQueue::StopPrefetch()
+    {
+        this->stop = true;
+        if(this->worker.joinable()) this->worker.join();
+    }
+
+    void InstallQueue::PrefetchMain()
+    {
+        u32 end = std::min((u32)this->paths.size(), this->taken + this->lookahead);
+        while(!this->stop && (this->next < end))
+        {
+            auto inst = std::make_unique<Installer>(this->paths[this->next], this->exp, this->location);
+            inst->Prefetch();
+            this->insts[this->next] = std::move(inst);
+            this->next++;
+        }
+    }
+}
@@ -28,13 +28,100 @@
 #include <malloc.h>
 #include <dirent.h>
 #include <chrono>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <numeric>
+#include <algorithm>
+#include <map>
+#include <deque>
+#include <condition_variable>
+#include <zstd.h>
 
 extern cfg::Settings global_settings;
 
 namespace nsp
 {
-    Installer::Installer(String Path, fs::Explorer *Exp, Storage Location) : nspentry(Exp, Path), storage(static_cast<NcmStorageId>(Location))
+    struct ContentJob
     {
+        // Size of the NCA written, and where the next block of it starts
+        u64 Size = 0;
+        u64 OutOffset = 0;
+        std::atomic<u64> Written{0};
+        std::atomic<u32> InFlight{0};
+        NcmContentStorage Storage = {};
+        NcmPlaceHolderId PlaceHolder = {};
+        bool Open = false;
+        bool Done = false;
+        // Expected SHA-256 (just its first half, the content id, when the cnmt has no hash for it), only touched by the hash stage
+        u8 Hash[0x20] = {};
+        u32 HashSize = 0;
+        Sha256Context Sha = {};
+        u64 Hashed = 0;
+        std::map<u64, fs::RingBlock> Pending;
+        // NCZs (from NSZs) are decompressed back into their NCA: solid ones by the reader, block ones by the writers
+        std::unique_ptr<NCZ> Ncz;
+        u64 SourceSize = 0;
+        u64 ReadOffset = 0;
+        u32 NextBlock = 0;
+        std::unique_ptr<ZSTD_DStream, size_t(*)(ZSTD_DStream*)> Stream{NULL, ZSTD_freeDStream};
+        std::vector<u8> In;
+        size_t InPos = 0;
+        size_t InSize = 0;
+    };
+
+    // Written blocks waiting to be hashed, their slots go back to the ring once they are
+    struct HashQueue
+    {
+        std::mutex Lock;
+        std::condition_variable Cv;
+        std::deque<fs::RingBlock> Blocks;
+        bool Closed = false;
+
+        void Push(fs::RingBlock Block)
+        {
+            {
+                std::lock_guard<std::mutex> lk(this->Lock);
+                this->Blocks.push_back(Block);
+            }
+            this->Cv.notify_one();
+        }
+
+        bool Pop(fs::RingBlock &Out)
+        {
+            std::unique_lock<std::mutex> lk(this->Lock);
+            this->Cv.wait(lk, [&]() { return this->Closed || !this->Blocks.empty(); });
+            if(this->Blocks.empty()) return false;
+            Out = this->Blocks.front();
+            this->Blocks.pop_front();
+            return true;
+        }
+
+        void Close()
+        {
+            {
+                std::lock_guard<std::mutex> lk(this->Lock);
+                this->Closed = true;
+            }
+            this->Cv.notify_all();
+        }
+    };
+
+    bool IsPackageExtension(String Ext)
+    {
+        return (Ext == "nsp") || (Ext == "nsz") || (Ext == "xci") || (Ext == "xcz");
+    }
+
+    std::unique_ptr<ContentSource> OpenPackage(fs::Explorer *Exp, String Path)
+    {
+        auto ext = fs::GetExtension(Path);
+        if((ext == "xci") || (ext == "xcz")) return OpenXCI(Exp, Path);
+        return std::make_unique<PFS0>(Exp, Path);
+    }
+
+    Installer::Installer(String Path, fs::Explorer *Exp, Storage Location) : source(OpenPackage(Exp, Path)), keygen(0), storage(static_cast<NcmStorageId>(Location)), stik(0), prefetched(false), prefetchrc(0), metaloaded(false), controlloaded(false), idxcnmtnca(0), scnmtnca(0), idxtik(0)
+    {
+        memset(&entrynacp, 0, sizeof(entrynacp));
     }
 
     Installer::~Installer()
@@ -42,159 +129,238 @@ namespace nsp
         FinalizeInstallation();
     }
 
-    Result Installer::PrepareInstallation()
+    Result Installer::Prefetch()
     {
-        auto rc = err::result::ResultInvalidNSP;
-        if(nspentry.IsOk())
+        // Safe to call again (and from another thread before PrepareInstallation), the work is done only once
+        if(prefetched) return prefetchrc;
+        prefetched = true;
+        prefetchrc = err::result::ResultInvalidNSP;
+        if(!source->IsOk()) return prefetchrc;
+        stik = 0;
+        scnmtnca = 0;
+        auto files = source->GetFiles();
+        for(u32 i = 0; i < files.size(); i++)
         {
-            rc = 0;
-            String cnmtnca;
-            u32 idxcnmtnca = 0;
-            u64 scnmtnca = 0;
-            u32 idxtik = 0;
-            stik = 0;
-            auto files = nspentry.GetFiles();
-            for(u32 i = 0; i < files.size(); i++)
+            String file = files[i];
+            if(fs::GetExtension(file) == "tik")
             {
-                String file = files[i];
-                if(fs::GetExtension(file) == "tik")
-                {
-                    tik = file;
-                    idxtik = i;
-                    stik = nspentry.GetFileSize(i);
-                }
-                else if(file.substr(file.length() - 8) == "cnmt.nca")
-                {
-                    cnmtnca = file;
-                    idxcnmtnca = i;
-                    scnmtnca = nspentry.GetFileSize(i);
-                }
+                tik = file;
+                idxtik = i;
+                stik = source->GetFileSize(i);
             }
-            if(scnmtnca == 0)
+            else if(file.substr(file.length() - 8) == "cnmt.nca")
             {
-                rc = err::result::ResultMetaNotFound;
-                return rc;
+                cnmtnca = file;
+                idxcnmtnca = i;
+                scnmtnca = source->GetFileSize(i);
             }
-            String icnmtnca = fs::GetFileName(cnmtnca);
-            fs::Explorer *nsys = fs::GetNANDSystemExplorer();
-            nsys->CreateDirectory("Contents/temp");
-            String ncnmtnca = nsys->FullPathFor("Contents/temp/" + cnmtnca);
-            nsys->DeleteFile(ncnmtnca);
-            nspentry.SaveFile(idxcnmtnca, nsys, ncnmtnca);
-            String acnmtnca = "@SystemContent://temp/" + cnmtnca;
-            acnmtnca.reserve(FS_MAX_PATH);
-            FsRightsId rid = {};
-            rc = fsGetRightsIdAndKeyGenerationByPath(acnmtnca.AsUTF8().c_str(), &keygen, &rid);
-            if(R_FAILED(rc)) return rc;
-            u8 systemkgen = hos::ComputeSystemKeyGeneration();
-            if(systemkgen < keygen)
-            {
-                rc = err::result::ResultKeyGenMismatch;
-                return rc;
-            }
-            FsFileSystem cnmtncafs;
-            rc = fsOpenFileSystemWithId(&cnmtncafs, 0, FsFileSystemType_ContentMeta, acnmtnca.AsUTF8().c_str());
+        }
+        prefetchrc = err::result::ResultMetaNotFound;
+        if(scnmtnca == 0) return prefetchrc;
+        // Only positioned reads of the NSP happen here, anything needing NAND staging is left for PrepareInstallation
+        metaloaded = LoadMeta(idxcnmtnca);
+        if(metaloaded) for(auto &rec: cnmt.GetContentRecords())
+        {
+            if(rec.Type != ncm::ContentType::Control) continue;
+            String controlncaid = hos::ContentIdAsString(rec.ContentId);
+            auto idxcontrolnca = source->GetFileIndexByName(controlncaid + ".nca");
+            controlloaded = idxcontrolnca.has_value() && LoadControl(idxcontrolnca.value(), controlncaid);
+            break;
+        }
+        prefetchrc = 0;
+        return prefetchrc;
+    }
+
+    Result Installer::PrepareInstallation()
+    {
+        auto rc = Prefetch();
+        if(R_FAILED(rc)) return rc;
+        ExportIcon();
+        ncas.clear();
+        String icnmtnca = fs::GetFileName(cnmtnca);
+        // NCAs are read in process when possible, otherwise they get staged in NAND so that FS can open them
+        if(!metaloaded)
+        {
+            rc = StageMeta(cnmtnca, idxcnmtnca);
             if(R_FAILED(rc)) return rc;
+        }
+        u8 systemkgen = hos::ComputeSystemKeyGeneration();
+        if(systemkgen < keygen)
+        {
+            rc = err::result::ResultKeyGenMismatch;
+            return rc;
+        }
+        ncm::ContentRecord record = {};
+        record.ContentId = hos::StringAsContentId(icnmtnca);
+        *(u64*)record.Size = (scnmtnca & 0xffffffffffff);
+        record.Type = ncm::ContentType::Meta;
+        auto tmprec = cnmt.GetContentMetaKey();
+        memcpy(&mrec, &tmprec, sizeof(NcmContentMetaKey));
+        if(hos::ExistsTitle(ncm::ContentMetaType::Any, Storage::SdCard, mrec.id))
+        {
+            rc = err::result::ResultTitleAlreadyInstalled;
+            return rc;
+        }
+        if(hos::ExistsTitle(ncm::ContentMetaType::Any, Storage::NANDUser, mrec.id))
+        {
+            rc = err::result::ResultTitleAlreadyInstalled;
+            return rc;
+        }
+        NcmContentStorage cst;
+        rc = ncmOpenContentStorage(&cst, storage);
+        bool hascnmt = false;
+        ncmContentStorageHas(&cst, &hascnmt, &record.ContentId);
+        serviceClose(&cst.s);
+        if(!hascnmt) ncas.push_back(record);
+        cnmt.GetInstallContentMeta(ccnmt, record, global_settings.ignore_required_fw_ver);
+        baseappid = hos::GetBaseApplicationId(mrec.id, static_cast<ncm::ContentMetaType>(mrec.type));
+        auto recs = cnmt.GetContentRecords();
+        hashedncas = cnmt.GetHashedContentRecords();
+        // Tickets are tiny, so they get staged in memory instead of NAND
+        String ptik = fs::GetRamExplorer()->FullPathFor(tik);
+        if(stik > 0)
+        {
+            source->SaveFile(idxtik, fs::GetRamExplorer(), ptik);
+            entrytik = hos::ReadTicket(ptik);
+        }
+        for(u32 i = 0; i < recs.size(); i++)
+        {
+            ncas.push_back(recs[i]);
+            if((recs[i].Type == ncm::ContentType::Control) && !controlloaded)
             {
-                fs::FileSystemExplorer cnmtfs("gnspcnmtnca", "NSP-ContentMeta", &cnmtncafs);
-                auto cnts = cnmtfs.GetContents();
-                String fcnmt;
-                for(u32 i = 0; i < cnts.size(); i++)
-                {
-                    String cnt = cnts[i];
-                    if(fs::GetExtension(cnt) == "cnmt")
-                    {
-                        fcnmt = cnt;
-                        break;
-                    }
-                }
-                if(fcnmt.empty())
-                {
-                    rc = err::result::ResultMetaNotFound;
-                    return rc;
-                }
-                u64 fcnmtsz = cnmtfs.GetFileSize(fcnmt);
-                u8 *cnmtbuf = new u8[fcnmtsz]();
-                cnmtfs.StartFile(fcnmt, fs::FileMode::Read);
-                cnmtfs.ReadFileBlock(fcnmt, 0, fcnmtsz, cnmtbuf);
-                cnmtfs.EndFile(fs::FileMode::Read);
-                cnmt = ncm::ContentMeta(cnmtbuf, fcnmtsz);
-                delete[] cnmtbuf;
-            }
-            ncm::ContentRecord record = {};
-            record.ContentId = hos::StringAsContentId(icnmtnca);
-            *(u64*)record.Size = (scnmtnca & 0xffffffffffff);
-            record.Type = ncm::ContentType::Meta;
-            auto tmprec = cnmt.GetContentMetaKey();
-            memcpy(&mrec, &tmprec, sizeof(NcmContentMetaKey));
-            if(hos::ExistsTitle(ncm::ContentMetaType::Any, Storage::SdCard, mrec.id))
-            {
-                rc = err::result::ResultTitleAlreadyInstalled;
-                return rc;
-            }
-            if(hos::ExistsTitle(ncm::ContentMetaType::Any, Storage::NANDUser, mrec.id))
-            {
-                rc = err::result::ResultTitleAlreadyInstalled;
-                return rc;
+                String controlncaid = hos::ContentIdAsString(recs[i].ContentId);
+                String controlnca = controlncaid + ".nca";
+                // Without the control NCA there is just no icon or NACP to show
+                auto idxcontrolnca = source->GetFileIndexByName(controlnca);
+                if(!idxcontrolnca.has_value()) continue;
+                if(LoadControl(idxcontrolnca.value(), controlncaid)) ExportIcon();
+                else StageControl(idxcontrolnca.value(), controlnca, controlncaid);
             }
-            NcmContentStorage cst;
-            rc = ncmOpenContentStorage(&cst, storage);
-            bool hascnmt = false;
-            ncmContentStorageHas(&cst, &hascnmt, &record.ContentId);
-            serviceClose(&cst.s);
-            if(!hascnmt) ncas.push_back(record);
-            cnmt.GetInstallContentMeta(ccnmt, record, global_settings.ignore_required_fw_ver);
-            baseappid = hos::GetBaseApplicationId(mrec.id, static_cast<ncm::ContentMetaType>(mrec.type));
-            auto recs = cnmt.GetContentRecords();
-            memset(&entrynacp, 0, sizeof(entrynacp));
-            String ptik = nsys->FullPathFor("Contents/temp/" + tik);
-            if(stik > 0)
+        }
+        return rc;
+    }
+
+    bool Installer::LoadMeta(u32 Index)
+    {
+        NCA nca(*source, Index);
+        if(!nca.IsOk()) return false;
+        for(auto &file: nca.ListSectionFiles(0))
+        {
+            if(fs::GetExtension(file.Name) != "cnmt") continue;
+            auto data = nca.ReadSectionFile(0, file);
+            if(data.empty()) return false;
+            keygen = nca.GetKeyGeneration();
+            cnmt = ncm::ContentMeta(data.data(), data.size());
+            return true;
+        }
+        return false;
+    }
+
+    Result Installer::StageMeta(String CnmtNca, u32 Index)
+    {
+        fs::Explorer *nsys = fs::GetNANDSystemExplorer();
+        nsys->CreateDirectory("Contents/temp");
+        String ncnmtnca = nsys->FullPathFor("Contents/temp/" + CnmtNca);
+        nsys->DeleteFile(ncnmtnca);
+        source->SaveFile(Index, nsys, ncnmtnca);
+        String acnmtnca = "@SystemContent://temp/" + CnmtNca;
+        acnmtnca.reserve(FS_MAX_PATH);
+        FsRightsId rid = {};
+        auto rc = fsGetRightsIdAndKeyGenerationByPath(acnmtnca.AsUTF8().c_str(), &keygen, &rid);
+        if(R_FAILED(rc)) return rc;
+        FsFileSystem cnmtncafs;
+        rc = fsOpenFileSystemWithId(&cnmtncafs, 0, FsFileSystemType_ContentMeta, acnmtnca.AsUTF8().c_str());
+        if(R_FAILED(rc)) return rc;
+        fs::FileSystemExplorer cnmtfs("gnspcnmtnca", "NSP-ContentMeta", &cnmtncafs);
+        auto cnts = cnmtfs.GetContents();
+        String fcnmt;
+        for(u32 i = 0; i < cnts.size(); i++)
+        {
+            String cnt = cnts[i];
+            if(fs::GetExtension(cnt) == "cnmt")
             {
-                nspentry.SaveFile(idxtik, nsys, ptik);
-                entrytik = hos::ReadTicket(ptik);
+                fcnmt = cnt;
+                break;
             }
-            for(u32 i = 0; i < recs.size(); i++)
+        }
+        if(fcnmt.empty()) return err::result::ResultMetaNotFound;
+        u64 fcnmtsz = cnmtfs.GetFileSize(fcnmt);
+        u8 *cnmtbuf = new u8[fcnmtsz]();
+        cnmtfs.StartFile(fcnmt, fs::FileMode::Read);
+        cnmtfs.ReadFileBlock(fcnmt, 0, fcnmtsz, cnmtbuf);
+        cnmtfs.EndFile(fs::FileMode::Read);
+        cnmt = ncm::ContentMeta(cnmtbuf, fcnmtsz);
+        delete[] cnmtbuf;
+        return 0;
+    }
+
+    bool Installer::LoadControl(u32 Index, String ControlNcaId)
+    {
+        NCA nca(*source, Index);
+        if(!nca.IsOk()) return false;
+        auto files = nca.ListSectionFiles(0);
+        bool hasnacp = false;
+        for(auto &file: files)
+        {
+            if(file.Name != "control.nacp") continue;
+            auto data = nca.ReadSectionFile(0, file, sizeof(NacpStruct));
+            if(data.size() != sizeof(NacpStruct)) return false;
+            memcpy(&entrynacp, data.data(), sizeof(NacpStruct));
+            hasnacp = true;
+            break;
+        }
+        if(!hasnacp) return false;
+        for(auto &file: files)
+        {
+            if(fs::GetExtension(file.Name) != "dat") continue;
+            auto data = nca.ReadSectionFile(0, file);
+            if(data.empty()) break;
+            icon = "sdmc:/" + consts::Root + "/meta/" + ControlNcaId + ".jpg";
+            // Only kept in memory: this runs on the read-ahead thread too, which must not write to the SD card
+            icondata = std::move(data);
+            break;
+        }
+        return true;
+    }
+
+    void Installer::ExportIcon()
+    {
+        if(icondata.empty()) return;
+        fs::WriteFile(icon, std::move(icondata));
+        icondata = std::vector<u8>();
+    }
+
+    void Installer::StageControl(u32 Index, String ControlNca, String ControlNcaId)
+    {
+        fs::Explorer *nsys = fs::GetNANDSystemExplorer();
+        nsys->CreateDirectory("Contents/temp");
+        auto ncontrolnca = nsys->FullPathFor("Contents/temp/" + ControlNca);
+        source->SaveFile(Index, nsys, ncontrolnca);
+        String acontrolnca = "@SystemContent://temp/" + ControlNca;
+        acontrolnca.reserve(FS_MAX_PATH);
+        FsFileSystem controlncafs;
+        auto rc = fsOpenFileSystemWithId(&controlncafs, mrec.id, FsFileSystemType_ContentControl, acontrolnca.AsUTF8().c_str());
+        if(R_FAILED(rc)) return;
+        fs::FileSystemExplorer controlfs("gnspcontrolnca", "NSP-Control", &controlncafs);
+        auto cnts = controlfs.GetContents();
+        for(u32 i = 0; i < cnts.size(); i++)
+        {
+            String cnt = cnts[i];
+            if(fs::GetExtension(cnt) == "dat")
             {
-                ncas.push_back(recs[i]);
-                if(recs[i].Type == ncm::ContentType::Control)
-                {
-                    String controlncaid = hos::ContentIdAsString(recs[i].ContentId);
-                    String controlnca = controlncaid + ".nca";
-                    u32 idxcontrolnca = nspentry.GetFileIndexByName(controlnca);
-                    auto ncontrolnca = nsys->FullPathFor("Contents/temp/" + controlnca);
-                    nspentry.SaveFile(idxcontrolnca, nsys, ncontrolnca);
-                    String acontrolnca = "@SystemContent://temp/" + controlnca;
-                    acontrolnca.reserve(FS_MAX_PATH);
-                    FsFileSystem controlncafs;
-                    auto rc2 = fsOpenFileSystemWithId(&controlncafs, mrec.id, FsFileSystemType_ContentControl, acontrolnca.AsUTF8().c_str());
-                    if(rc2 == 0)
-                    {
-                        fs::FileSystemExplorer controlfs("gnspcontrolnca", "NSP-Control", &controlncafs);
-                        auto cnts = controlfs.GetContents();
-                        for(u32 i = 0; i < cnts.size(); i++)
-                        {
-                            String cnt = cnts[i];
-                            if(fs::GetExtension(cnt) == "dat")
-                            {
-                                icon = "sdmc:/" + consts::Root + "/meta/" + controlncaid + ".jpg";
-                                controlfs.CopyFile(cnt, icon);
-                                break;
-                            }
-                        }
-                        auto fcontrol = "control.nacp";
-                        controlfs.StartFile(fcontrol, fs::FileMode::Read);
-                        controlfs.ReadFileBlock(fcontrol, 0, sizeof(NacpStruct), (u8*)&entrynacp);
-                        controlfs.EndFile(fs::FileMode::Read);
-                    }
-                }
+                icon = "sdmc:/" + consts::Root + "/meta/" + ControlNcaId + ".jpg";
+                controlfs.CopyFile(cnt, icon);
+                break;
             }
         }
-        return rc;
+        auto fcontrol = "control.nacp";
+        controlfs.StartFile(fcontrol, fs::FileMode::Read);
+        controlfs.ReadFileBlock(fcontrol, 0, sizeof(NacpStruct), (u8*)&entrynacp);
+        controlfs.EndFile(fs::FileMode::Read);
     }
 
     Result Installer::PreProcessContents()
     {
-        fs::Explorer *nsys = fs::GetNANDSystemExplorer();
         NcmContentMetaDatabase mdb;
         Result rc = ncmOpenContentMetaDatabase(&mdb, storage);
         if(R_FAILED(rc)) return rc;
@@ -235,12 +401,12 @@ namespace nsp
         rc = ns::PushApplicationRecord(baseappid, 3, srecs.data(), srecs.size() * sizeof(ns::ContentStorageRecord));
         if(stik > 0)
         {
+            auto ram = fs::GetRamExplorer();
             u8 *tikbuf = fs::GetFileSystemOperationsBuffer();
-            auto nmtik = "Contents/temp/" + tik;
-            nsys->StartFile(nmtik, fs::FileMode::Read);
-            nsys->ReadFileBlock(nmtik, 0, stik, tikbuf);
-            nsys->EndFile(fs::FileMode::Read);
+            auto ptik = ram->FullPathFor(tik);
+            ram->ReadFileBlock(ptik, 0, stik, tikbuf);
             rc = es::ImportTicket(tikbuf, stik, es::CertData, es::CertSize);
+            ram->DeleteFile(ptik);
         }
         return rc;
     }
@@ -287,95 +453,333 @@ namespace nsp
 
     Result Installer::WriteContents(std::function<void(ncm::ContentRecord Record, u32 Content, u32 ContentCount, double Done, double Total, u64 BytesSec)> OnContentWrite)
     {
-        fs::Explorer *nsys = fs::GetNANDSystemExplorer();
         Result rc = 0;
-        u64 reads = fs::GetFileSystemOperationsBufferSize();
-        u8 *rdata = fs::GetFileSystemOperationsBuffer();
         u64 totalsize = 0;
-        u64 twrittensize = 0;
-        std::vector<String> ncanames;
-        std::vector<u64> ncasizes;
         std::vector<u32> ncaidxs;
+        std::vector<bool> nczs;
         for(auto &rnca: ncas)
         {
             NcmContentId curid = rnca.ContentId;
             String ncaname = hos::ContentIdAsString(curid);
             if(rnca.Type == ncm::ContentType::Meta) ncaname += ".cnmt";
-            ncaname += ".nca";
-            u32 idxncaname = nspentry.GetFileIndexByName(ncaname);
-            auto cursize =  nspentry.GetFileSize(idxncaname);
-            totalsize += cursize;
-            ncaidxs.push_back(idxncaname);
-            ncanames.push_back(ncaname);
-            ncasizes.push_back(cursize);
+            auto idxncaname = source->GetFileIndexByName(ncaname + ".nca");
+            bool ncz = false;
+            if(!idxncaname.has_value() && (rnca.Type != ncm::ContentType::Meta))
+            {
+                idxncaname = source->GetFileIndexByName(ncaname + ".ncz");
+                ncz = idxncaname.has_value();
+            }
+            if(!idxncaname.has_value()) return err::result::ResultContentNotFound;
+            ncaidxs.push_back(idxncaname.value());
+            nczs.push_back(ncz);
         }
+
+        // One reader thread feeds the ring with chunks of several contents at once, and a pool of writers drains it into their placeholders.
+        // This thread only reports progress, since the callback drives the UI.
+        fs::BlockRing ring(fs::GetFileSystemOperationsBuffer(), fs::GetFileSystemOperationsBufferSize(), InstallRingSlotCount);
+        std::vector<ContentJob> jobs(ncas.size());
+        bool verify = global_settings.verify_install_hashes;
         for(u32 i = 0; i < ncas.size(); i++)
         {
-            ncm::ContentRecord rnca = ncas[i];
-            NcmContentId curid = rnca.ContentId;
-            String ncaname = ncanames[i];
-            u64 ncasize = ncasizes[i];
-            u32 idxncaname = ncaidxs[i];
-
-            NcmContentStorage cst;
-            ncmOpenContentStorage(&cst, storage);
-
-            NcmPlaceHolderId plhdid = {};
-            memcpy(plhdid.uuid.uuid, curid.c, sizeof(curid.c));
-            
-            ncmContentStorageDeletePlaceHolder(&cst, &plhdid);
-            ncmContentStorageCreatePlaceHolder(&cst, &curid, &plhdid, ncasize);
-            u64 noff = 0;
-            u64 szrem = ncasize;
-            auto nmnca = "Contents/temp/" + ncaname;
-            switch(rnca.Type)
+            auto &job = jobs[i];
+            job.SourceSize = source->GetFileSize(ncaidxs[i]);
+            job.Size = job.SourceSize;
+            if(nczs[i])
             {
-                case ncm::ContentType::Meta:
-                case ncm::ContentType::Control:
-                    nsys->StartFile(nmnca, fs::FileMode::Read);
-                    break;
-                default:
-                    nspentry.GetExplorer()->StartFile(nspentry.GetPath(), fs::FileMode::Read);
-                    break;
+                job.Ncz = std::make_unique<NCZ>(*source, ncaidxs[i]);
+                if(!job.Ncz->IsOk()) return err::result::ResultInvalidNSP;
+                // A decompressed block has to fit in a slot
+                if(job.Ncz->IsBlockCompressed() && (job.Ncz->GetBlockSize() > ring.GetSlotSize())) return err::result::ResultInvalidNSP;
+                job.Size = 0;
+                memcpy(&job.Size, ncas[i].Size, sizeof(ncas[i].Size));
+                if(!job.Ncz->IsBlockCompressed())
+                {
+                    job.Stream.reset(ZSTD_createDStream());
+                    if(!job.Stream) return err::result::ResultInvalidNSP;
+                    ZSTD_initDStream(job.Stream.get());
+                    job.In.resize(ZSTD_DStreamInSize());
+                    job.ReadOffset = job.Ncz->GetDataOffset();
+                }
+            }
+            totalsize += job.Size;
+            if(!verify) continue;
+            sha256ContextCreate(&job.Sha);
+            memcpy(job.Hash, ncas[i].ContentId.c, sizeof(ncas[i].ContentId.c));
+            job.HashSize = sizeof(ncas[i].ContentId.c);
+            for(auto &hrec: hashedncas)
+            {
+                if(memcmp(hrec.Record.ContentId.c, ncas[i].ContentId.c, sizeof(ncas[i].ContentId.c)) != 0) continue;
+                memcpy(job.Hash, hrec.Hash, sizeof(job.Hash));
+                job.HashSize = sizeof(job.Hash);
+                break;
+            }
+        }
+        std::mutex rclock;
+        auto fail = [&](Result Rc)
+        {
+            {
+                std::lock_guard<std::mutex> lk(rclock);
+                if(R_SUCCEEDED(rc)) rc = Rc;
             }
-            while(szrem)
+            ring.Cancel();
+        };
+        auto finalize = [&](u32 Index)
+        {
+            auto &job = jobs[Index];
+            NcmContentId curid = ncas[Index].ContentId;
+            ncmContentStorageRegister(&job.Storage, &curid, &job.PlaceHolder);
+            ncmContentStorageDeletePlaceHolder(&job.Storage, &job.PlaceHolder);
+            serviceClose(&job.Storage.s);
+            job.Done = true;
+        };
+
+        fs::GetFileIndex().Pause();
+        std::thread reader([&]()
+        {
+            auto nspexp = source->GetExplorer();
+            nspexp->StartFile(source->GetPath(), fs::FileMode::Read);
+            // The biggest content starts right away, the rest go from smallest to biggest so that they finish while it streams
+            std::vector<u32> order(ncas.size());
+            std::iota(order.begin(), order.end(), 0);
+            std::sort(order.begin(), order.end(), [&](u32 A, u32 B) { return jobs[A].Size < jobs[B].Size; });
+            if(!order.empty()) std::rotate(order.rbegin(), order.rbegin() + 1, order.rend());
+            std::vector<u32> active;
+            u32 nextact = 0;
+            bool ok = true;
+            auto activate = [&]()
             {
-                u64 rbytes = 0;
-                u64 rsize = std::min(szrem, reads);
-                auto t1 = std::chrono::steady_clock::now();
-                switch(rnca.Type)
+                while(ok && (active.size() < InstallMaxConcurrentContents) && (nextact < order.size()))
                 {
-                    case ncm::ContentType::Meta:
-                    case ncm::ContentType::Control:
-                        rbytes = nsys->ReadFileBlock(nmnca, noff, rsize, rdata);
+                    u32 idx = order[nextact++];
+                    auto &job = jobs[idx];
+                    NcmContentId curid = ncas[idx].ContentId;
+                    Result arc = ncmOpenContentStorage(&job.Storage, storage);
+                    if(R_FAILED(arc))
+                    {
+                        fail(arc);
+                        ok = false;
                         break;
-                    default:
-                        rbytes = nspentry.ReadFromFile(idxncaname, noff, rsize, rdata);
+                    }
+                    memcpy(job.PlaceHolder.uuid.uuid, curid.c, sizeof(curid.c));
+                    ncmContentStorageDeletePlaceHolder(&job.Storage, &job.PlaceHolder);
+                    arc = ncmContentStorageCreatePlaceHolder(&job.Storage, &curid, &job.PlaceHolder, job.Size);
+                    job.Open = true;
+                    if(R_FAILED(arc))
+                    {
+                        fail(arc);
+                        ok = false;
+                        break;
+                    }
+                    if(job.Size == 0) finalize(idx);
+                    else active.push_back(idx);
+                }
+            };
+            // Fills a slot with the next data of a content: returns the size pushed (0 on errors) and how much of the NCA it stands for
+            auto readblock = [&](u32 Index, u8 *Slot, u64 &OutSize) -> u64
+            {
+                auto &job = jobs[Index];
+                u64 slotsize = ring.GetSlotSize();
+                OutSize = 0;
+                // Plain NCAs, and the untouched start of NCZs
+                if(!job.Ncz || (job.OutOffset < NCZHeaderOffset))
+                {
+                    u64 rsize = std::min(job.Size - job.OutOffset, slotsize);
+                    if(job.Ncz) rsize = std::min(rsize, NCZHeaderOffset - job.OutOffset);
+                    OutSize = source->ReadFromFile(ncaidxs[Index], job.OutOffset, rsize, Slot);
+                    return OutSize;
+                }
+                if(job.Ncz->IsBlockCompressed())
+                {
+                    // Blocks which didn't shrink are stored as they are, as big as they decompress to
+                    u32 block = job.NextBlock++;
+                    if(block >= job.Ncz->GetBlockCount()) return 0;
+                    OutSize = std::min(job.Ncz->GetBlockSize(), job.Size - job.OutOffset);
+                    u64 rsize = std::min(job.Ncz->GetCompressedBlockSize(block), OutSize);
+                    if(source->ReadFromFile(ncaidxs[Index], job.Ncz->GetBlockOffset(block), rsize, Slot) != rsize) return 0;
+                    return rsize;
+                }
+                ZSTD_outBuffer out = { Slot, (size_t)std::min(job.Size - job.OutOffset, slotsize), 0 };
+                while(out.pos < out.size)
+                {
+                    if(job.InPos == job.InSize)
+                    {
+                        u64 rsize = std::min((u64)job.In.size(), job.SourceSize - job.ReadOffset);
+                        if(rsize == 0) break;
+                        u64 rbytes = source->ReadFromFile(ncaidxs[Index], job.ReadOffset, rsize, job.In.data());
+                        if(rbytes == 0) break;
+                        job.ReadOffset += rbytes;
+                        job.InPos = 0;
+                        job.InSize = rbytes;
+                    }
+                    ZSTD_inBuffer in = { job.In.data(), job.InSize, job.InPos };
+                    auto zrc = ZSTD_decompressStream(job.Stream.get(), &out, &in);
+                    job.InPos = in.pos;
+                    if(ZSTD_isError(zrc)) return 0;
+                }
+                OutSize = out.pos;
+                return out.pos;
+            };
+            activate();
+            u32 rr = 0;
+            while(ok && !active.empty())
+            {
+                u8 *slot = ring.AcquireFree();
+                if(slot == NULL) break;
+                // Round-robin over the active contents, each one holding at most its share of the slots
+                u32 share = (InstallRingSlotCount + active.size() - 1) / active.size();
+                u32 pick = rr % active.size();
+                for(u32 k = 0; k < active.size(); k++)
+                {
+                    u32 cand = (rr + k) % active.size();
+                    if(jobs[active[cand]].InFlight.load() < share)
+                    {
+                        pick = cand;
                         break;
+                    }
                 }
-                ncmContentStorageWritePlaceHolder(&cst, &plhdid, noff, rdata, rbytes);
-                noff += rbytes;
-                szrem -= rbytes;
-                auto t2 = std::chrono::steady_clock::now();
-                u64 diff = std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count();
-                double bsec = (1000.0f / (double)diff) * rbytes; // By elapsed time and written bytes, compute how much data has been written in 1sec.
-                OnContentWrite(rnca, i, ncas.size(), (double)(noff + twrittensize), (double)totalsize, (u64)bsec);
+                u32 idx = active[pick];
+                auto &job = jobs[idx];
+                u64 outsize = 0;
+                u64 rbytes = readblock(idx, slot, outsize);
+                job.InFlight++;
+                // An empty block tells the writers that the source couldn't be read
+                ring.Push({ slot, idx, job.OutOffset, rbytes });
+                if(rbytes == 0) break;
+                job.OutOffset += outsize;
+                if(job.OutOffset >= job.Size)
+                {
+                    active.erase(active.begin() + pick);
+                    activate();
+                    rr = pick;
+                }
+                else rr = pick + 1;
             }
-            switch(rnca.Type)
+            nspexp->EndFile(fs::FileMode::Read);
+            ring.Finish();
+        });
+
+        // When verifying, written blocks go through a hash stage which keeps their slots and registers each content once its hash matches
+        HashQueue hashq;
+        std::atomic<u32> writersleft(InstallMaxConcurrentContents);
+        std::atomic<u32> running(InstallMaxConcurrentContents + (verify ? 1 : 0));
+        std::vector<std::thread> writers;
+        for(u32 i = 0; i < InstallMaxConcurrentContents; i++)
+        {
+            writers.emplace_back([&]()
             {
-                case ncm::ContentType::Meta:
-                case ncm::ContentType::Control:
-                    nsys->EndFile(fs::FileMode::Read);
-                    break;
-                default:
-                    nspentry.GetExplorer()->EndFile(fs::FileMode::Read);
+                std::vector<u8> scratch;
+                std::unique_ptr<ZSTD_DCtx, size_t(*)(ZSTD_DCtx*)> dctx(NULL, ZSTD_freeDCtx);
+                fs::RingBlock block = {};
+                while(ring.Pop(block))
+                {
+                    auto &job = jobs[block.Tag];
+                    if(job.Ncz && (block.Offset >= NCZHeaderOffset) && (block.Size > 0))
+                    {
+                        u64 outsize = job.Ncz->IsBlockCompressed() ? std::min(job.Ncz->GetBlockSize(), job.Size - block.Offset) : block.Size;
+                        if(block.Size < outsize)
+                        {
+                            if(!dctx) dctx.reset(ZSTD_createDCtx());
+                            scratch.resize(ring.GetSlotSize());
+                            memcpy(scratch.data(), block.Data, block.Size);
+                            auto zrc = dctx ? ZSTD_decompressDCtx(dctx.get(), block.Data, outsize, scratch.data(), block.Size) : 0;
+                            block.Size = (!ZSTD_isError(zrc) && (zrc == outsize)) ? outsize : 0;
+                        }
+                        // What's left of the NCA was stored decrypted
+                        if(block.Size > 0) job.Ncz->Encrypt(block.Offset, block.Data, block.Size);
+                    }
+                    Result wrc = err::result::ResultInvalidNSP;
+                    if(block.Size > 0) wrc = ncmContentStorageWritePlaceHolder(&job.Storage, &job.PlaceHolder, block.Offset, block.Data, block.Size);
+                    if(R_FAILED(wrc) || !verify)
+                    {
+                        ring.Release(block.Data);
+                        job.InFlight--;
+                    }
+                    if(R_FAILED(wrc))
+                    {
+                        fail(wrc);
+                        break;
+                    }
+                    bool last = (job.Written.fetch_add(block.Size) + block.Size) == job.Size;
+                    if(verify) hashq.Push(block);
+                    // Whoever writes the last bytes registers the content
+                    else if(last) finalize(block.Tag);
+                }
+                if(--writersleft == 0) hashq.Close();
+                running--;
+            });
+        }
+        std::thread hasher;
+        if(verify) hasher = std::thread([&]()
+        {
+            fs::RingBlock block = {};
+            while(hashq.Pop(block))
+            {
+                auto &job = jobs[block.Tag];
+                job.Pending[block.Offset] = block;
+                // Writers can hand blocks of the same content back out of order
+                for(auto it = job.Pending.find(job.Hashed); it != job.Pending.end(); it = job.Pending.find(job.Hashed))
+                {
+                    auto hblock = it->second;
+                    job.Pending.erase(it);
+                    sha256ContextUpdate(&job.Sha, hblock.Data, hblock.Size);
+                    job.Hashed += hblock.Size;
+                    ring.Release(hblock.Data);
+                    job.InFlight--;
+                }
+                if(job.Hashed < job.Size) continue;
+                u8 hash[0x20] = {};
+                sha256ContextGetHash(&job.Sha, hash);
+                // A mismatching placeholder is never registered, and gets deleted below
+                if(memcmp(hash, job.Hash, job.HashSize) != 0)
+                {
+                    fail(err::result::ResultContentHashMismatch);
                     break;
+                }
+                finalize(block.Tag);
+            }
+            running--;
+        });
+
+        auto t1 = std::chrono::steady_clock::now();
+        u64 prevdone = 0;
+        while(running.load() > 0)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(InstallProgressIntervalMs));
+            u64 done = 0;
+            u32 cur = 0;
+            u64 curleft = 0;
+            for(u32 i = 0; i < jobs.size(); i++)
+            {
+                u64 written = jobs[i].Written.load();
+                done += written;
+                // Show the biggest content still being written
+                if((jobs[i].Size - written) > curleft)
+                {
+                    curleft = jobs[i].Size - written;
+                    cur = i;
+                }
+            }
+            auto t2 = std::chrono::steady_clock::now();
+            u64 diff = std::max((u64)std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count(), (u64)1);
+            t1 = t2;
+            double bsec = (1000.0f / (double)diff) * (done - prevdone); // By elapsed time and written bytes, compute how much data has been written in 1sec.
+            prevdone = done;
+            if(!jobs.empty()) OnContentWrite(ncas[cur], cur, ncas.size(), (double)done, (double)totalsize, (u64)bsec);
+        }
+        ring.Cancel();
+        reader.join();
+        for(auto &writer: writers) writer.join();
+        if(hasher.joinable()) hasher.join();
+        for(auto &job: jobs)
+        {
+            // Stopped halfway: don't leave placeholders behind
+            if(job.Open && !job.Done)
+            {
+                ncmContentStorageDeletePlaceHolder(&job.Storage, &job.PlaceHolder);
+                serviceClose(&job.Storage.s);
             }
-            twrittensize += noff;
-            ncmContentStorageRegister(&cst, &curid, &plhdid);
-            ncmContentStorageDeletePlaceHolder(&cst, &plhdid);
-            serviceClose(&cst.s);
         }
+        fs::GetFileIndex().Resume();
         return rc;
     }
 
@@ -383,5 +787,6 @@ namespace nsp
     {
         fs::Explorer *nsys = fs::GetNANDSystemExplorer();
         nsys->DeleteDirectory("Contents/temp");
+        if(stik > 0) fs::GetRamExplorer()->DeleteFile(fs::GetRamExplorer()->FullPathFor(tik));
     }
 }
\ No newline at end of file
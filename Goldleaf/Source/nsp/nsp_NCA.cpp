@@ -0,0 +1,245 @@
+
+/*
+
+    Goldleaf - Multipurpose homebrew tool for Nintendo Switch
+    Copyright (C) 2018-2019  XorTroll
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+#include <nsp/nsp_NCA.hpp>
+#include <fstream>
+#include <cstring>
+#include <algorithm>
+
+namespace nsp
+{
+    struct KeySet
+    {
+        u8 HeaderKey[0x20];
+        bool HasHeaderKey;
+        // Application, ocean and system key area keys, per key generation
+        u8 KeyAreaKeys[3][0x20][0x10];
+        bool HasKeyAreaKeys[3][0x20];
+    };
+
+    static KeySet keys = {};
+    static bool keysloaded = false;
+
+    static std::string TrimKeyToken(std::string Str)
+    {
+        auto start = Str.find_first_not_of(" \t\r\n");
+        if(start == std::string::npos) return "";
+        auto end = Str.find_last_not_of(" \t\r\n");
+        return Str.substr(start, end - start + 1);
+    }
+
+    static bool ParseKeyHex(const std::string &Str, u8 *Out, size_t Size)
+    {
+        if(Str.length() != (Size * 2)) return false;
+        for(size_t i = 0; i < Size; i++)
+        {
+            auto byte = Str.substr(i * 2, 2);
+            if(byte.find_first_not_of("0123456789abcdefABCDEF") != std::string::npos) return false;
+            Out[i] = (u8)std::stoul(byte, nullptr, 16);
+        }
+        return true;
+    }
+
+    bool LoadKeys()
+    {
+        if(keysloaded) return keys.HasHeaderKey;
+        keysloaded = true;
+        static const char *kaektypes[] = { "application", "ocean", "system" };
+        for(auto &path: { "sdmc:/" + consts::Root + "/prod.keys", std::string("sdmc:/switch/prod.keys") })
+        {
+            std::ifstream ifs(path);
+            if(!ifs.good()) continue;
+            std::string line;
+            while(std::getline(ifs, line))
+            {
+                auto eq = line.find('=');
+                if(eq == std::string::npos) continue;
+                auto name = TrimKeyToken(line.substr(0, eq));
+                auto value = TrimKeyToken(line.substr(eq + 1));
+                if(name == "header_key")
+                {
+                    keys.HasHeaderKey = ParseKeyHex(value, keys.HeaderKey, sizeof(keys.HeaderKey));
+                    continue;
+                }
+                for(u32 i = 0; i < 3; i++)
+                {
+                    std::string prefix = std::string("key_area_key_") + kaektypes[i] + "_";
+                    if(name.compare(0, prefix.length(), prefix) != 0) continue;
+                    auto gen = name.substr(prefix.length());
+                    if((gen.length() != 2) || (gen.find_first_not_of("0123456789abcdefABCDEF") != std::string::npos)) continue;
+                    u32 kgen = std::stoul(gen, nullptr, 16);
+                    if(kgen < 0x20) keys.HasKeyAreaKeys[i][kgen] = ParseKeyHex(value, keys.KeyAreaKeys[i][kgen], 0x10);
+                }
+            }
+            break;
+        }
+        return keys.HasHeaderKey;
+    }
+
+    NCA::NCA(ContentSource &Source, u32 Index) : source(Source), idx(Index), header(), fsheaders(), ctrkey(), ok(false)
+    {
+        if(!LoadKeys()) return;
+        if(Source.GetFileSize(Index) < NCAHeaderSize) return;
+        std::vector<u8> raw(NCAHeaderSize);
+        if(Source.ReadFromFile(Index, 0, NCAHeaderSize, raw.data()) != NCAHeaderSize) return;
+        // NCA3 headers are encrypted as consecutive XTS sectors (with Nintendo's tweak) from 0
+        Aes128XtsContext xts;
+        aes128XtsContextCreate(&xts, keys.HeaderKey, keys.HeaderKey + 0x10, false);
+        for(u64 sector = 0; sector < (NCAHeaderSize / NCAMediaUnitSize); sector++)
+        {
+            u8 *data = raw.data() + (sector * NCAMediaUnitSize);
+            aes128XtsContextResetSector(&xts, sector, true);
+            aes128XtsDecrypt(&xts, data, data, NCAMediaUnitSize);
+        }
+        memcpy(&this->header, raw.data(), sizeof(NCAHeader));
+        if(this->header.Magic != NCAMagic) return;
+        memcpy(this->fsheaders, raw.data() + sizeof(NCAHeader), sizeof(this->fsheaders));
+        // Titlekey crypto needs the ticket's key, left to FS
+        if(this->HasRightsId()) return;
+        u8 kgen = this->GetKeyGeneration();
+        u8 kidx = (kgen > 0) ? (kgen - 1) : 0;
+        u8 kaek = this->header.KeyAreaEncryptionKeyIndex;
+        if((kaek >= 3) || (kidx >= 0x20) || !keys.HasKeyAreaKeys[kaek][kidx]) return;
+        Aes128Context aes;
+        aes128ContextCreate(&aes, keys.KeyAreaKeys[kaek][kidx], false);
+        aes128DecryptBlock(&aes, this->ctrkey, this->header.EncryptedKeyArea[2]);
+        this->ok = true;
+    }
+
+    bool NCA::IsOk()
+    {
+        return this->ok;
+    }
+
+    u8 NCA::GetKeyGeneration()
+    {
+        return std::max(this->header.KeyGenerationOld, this->header.KeyGeneration);
+    }
+
+    bool NCA::HasRightsId()
+    {
+        for(u32 i = 0; i < sizeof(this->header.RightsId); i++) if(this->header.RightsId[i] != 0) return true;
+        return false;
+    }
+
+    bool NCA::ReadSection(u32 Section, u64 Offset, u64 Size, u8 *Out)
+    {
+        auto &ent = this->header.SectionEntries[Section];
+        u64 secstart = (u64)ent.MediaStartOffset * NCAMediaUnitSize;
+        u64 secend = (u64)ent.MediaEndOffset * NCAMediaUnitSize;
+        u64 abs = secstart + Offset;
+        if((abs + Size) > secend) return false;
+        auto &fsh = this->fsheaders[Section];
+        switch(static_cast<NCAEncryptionType>(fsh.EncryptionType))
+        {
+            case NCAEncryptionType::None:
+                return (this->source.ReadFromFile(this->idx, abs, Size, Out) == Size);
+            case NCAEncryptionType::AesCtr:
+            {
+                // CTR works on 0x10-byte blocks, so read from the block boundaries around the range
+                u64 aoff = abs & ~0xFul;
+                u64 pre = abs - aoff;
+                u64 asize = (pre + Size + 0xF) & ~0xFul;
+                std::vector<u8> buf(asize);
+                if(this->source.ReadFromFile(this->idx, aoff, asize, buf.data()) != asize) return false;
+                u8 ctr[0x10] = {};
+                for(u32 i = 0; i < 0x8; i++) ctr[i] = fsh.SectionCtr[0x7 - i];
+                u64 block = aoff >> 4;
+                for(u32 i = 0; i < 0x8; i++) ctr[0xF - i] = (u8)(block >> (8 * i));
+                Aes128CtrContext actx;
+                aes128CtrContextCreate(&actx, this->ctrkey, ctr);
+                aes128CtrCrypt(&actx, buf.data(), buf.data(), asize);
+                memcpy(Out, buf.data() + pre, Size);
+                return true;
+            }
+            default:
+                return false;
+        }
+    }
+
+    std::vector<NCASectionFile> NCA::ListSectionFiles(u32 Section)
+    {
+        std::vector<NCASectionFile> files;
+        if(!this->ok || (Section >= 4)) return files;
+        if(this->header.SectionEntries[Section].MediaEndOffset == 0) return files;
+        auto &fsh = this->fsheaders[Section];
+        switch(static_cast<NCAFsType>(fsh.FsType))
+        {
+            case NCAFsType::PFS0:
+            {
+                // The PFS0 offset is the last layer of the hierarchical SHA-256 info
+                u64 pfsoff = 0;
+                memcpy(&pfsoff, fsh.HashInfo + 0x38, sizeof(u64));
+                PFS0Header ph = {};
+                if(!this->ReadSection(Section, pfsoff, sizeof(ph), (u8*)&ph) || (ph.Magic != Magic)) break;
+                u64 entsize = sizeof(PFS0FileEntry) * (u64)ph.FileCount;
+                u64 metasize = entsize + ph.StringTableSize;
+                if(metasize > PFS0MaxHeaderSize) break;
+                std::vector<u8> meta(metasize);
+                if(!this->ReadSection(Section, pfsoff + sizeof(ph), metasize, meta.data())) break;
+                u64 dataoff = pfsoff + sizeof(ph) + metasize;
+                for(u32 i = 0; i < ph.FileCount; i++)
+                {
+                    PFS0FileEntry ent = {};
+                    memcpy(&ent, meta.data() + (i * sizeof(PFS0FileEntry)), sizeof(PFS0FileEntry));
+                    if(ent.StringTableOffset >= ph.StringTableSize) continue;
+                    auto name = (const char*)meta.data() + entsize + ent.StringTableOffset;
+                    files.push_back({ std::string(name, strnlen(name, ph.StringTableSize - ent.StringTableOffset)), dataoff + ent.Offset, ent.Size });
+                }
+                break;
+            }
+            case NCAFsType::RomFs:
+            {
+                // The RomFS is the last (6th) level of the IVFC info
+                u64 romoff = 0;
+                memcpy(&romoff, fsh.HashInfo + 0x88, sizeof(u64));
+                RomFsHeader rh = {};
+                if(!this->ReadSection(Section, romoff, sizeof(rh), (u8*)&rh)) break;
+                RomFsDirectoryEntry root = {};
+                if(!this->ReadSection(Section, romoff + rh.DirectoryMetaTableOffset, sizeof(root), (u8*)&root)) break;
+                if(rh.FileMetaTableSize > NCAMaxReadFileSize) break;
+                std::vector<u8> fmeta(rh.FileMetaTableSize);
+                if(!this->ReadSection(Section, romoff + rh.FileMetaTableOffset, fmeta.size(), fmeta.data())) break;
+                u32 cur = root.ChildFile;
+                while((cur != 0xFFFFFFFF) && ((cur + sizeof(RomFsFileEntry)) <= fmeta.size()) && (files.size() < fmeta.size()))
+                {
+                    RomFsFileEntry fe = {};
+                    memcpy(&fe, fmeta.data() + cur, sizeof(fe));
+                    u64 namelen = std::min((u64)fe.NameLength, (u64)(fmeta.size() - cur - sizeof(fe)));
+                    files.push_back({ std::string((const char*)fmeta.data() + cur + sizeof(fe), namelen), romoff + rh.FileDataOffset + fe.DataOffset, fe.DataSize });
+                    cur = fe.Sibling;
+                }
+                break;
+            }
+        }
+        return files;
+    }
+
+    std::vector<u8> NCA::ReadSectionFile(u32 Section, const NCASectionFile &File, u64 MaxSize)
+    {
+        std::vector<u8> data;
+        if(!this->ok || (Section >= 4) || (File.Size > MaxSize)) return data;
+        data.resize(File.Size);
+        if(!this->ReadSection(Section, File.Offset, File.Size, data.data())) data.clear();
+        return data;
+    }
+}
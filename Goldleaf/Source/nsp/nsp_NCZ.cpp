@@ -0,0 +1,123 @@
+
+/*
+
+    Goldleaf - Multipurpose homebrew tool for Nintendo Switch
+    Copyright (C) 2018-2019  XorTroll
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+#include <nsp/nsp_NCZ.hpp>
+#include <cstring>
+#include <algorithm>
+
+namespace nsp
+{
+    NCZ::NCZ(ContentSource &Source, u32 Index) : blocks(false), blocksize(0), dataoff(0), ok(false)
+    {
+        u64 fsize = Source.GetFileSize(Index);
+        u64 hdr[2] = {};
+        if(Source.ReadFromFile(Index, NCZHeaderOffset, sizeof(hdr), (u8*)hdr) != sizeof(hdr)) return;
+        if((hdr[0] != NCZSectionMagic) || (hdr[1] == 0) || (hdr[1] > NCZMaxSectionCount)) return;
+        this->sections.resize(hdr[1]);
+        u64 secsize = sizeof(NCZSection) * hdr[1];
+        u64 off = NCZHeaderOffset + sizeof(hdr);
+        if(Source.ReadFromFile(Index, off, secsize, (u8*)this->sections.data()) != secsize) return;
+        off += secsize;
+        // Without a block header, the rest is a single zstd stream
+        NCZBlockHeader bhdr = {};
+        if((Source.ReadFromFile(Index, off, sizeof(bhdr), (u8*)&bhdr) == sizeof(bhdr)) && (bhdr.Magic == NCZBlockMagic))
+        {
+            if((bhdr.BlockSizeExponent < 14) || (bhdr.BlockSizeExponent > 32) || (bhdr.BlockCount == 0)) return;
+            off += sizeof(bhdr);
+            u64 listsize = sizeof(u32) * (u64)bhdr.BlockCount;
+            if((off + listsize) > fsize) return;
+            this->blocksizes.resize(bhdr.BlockCount);
+            if(Source.ReadFromFile(Index, off, listsize, (u8*)this->blocksizes.data()) != listsize) return;
+            off += listsize;
+            u64 boff = off;
+            for(auto bsize: this->blocksizes)
+            {
+                this->blockoffs.push_back(boff);
+                boff += bsize;
+            }
+            this->blocks = true;
+            this->blocksize = 1ul << bhdr.BlockSizeExponent;
+        }
+        this->dataoff = off;
+        this->ok = true;
+    }
+
+    bool NCZ::IsOk()
+    {
+        return this->ok;
+    }
+
+    bool NCZ::IsBlockCompressed()
+    {
+        return this->blocks;
+    }
+
+    u64 NCZ::GetBlockSize()
+    {
+        return this->blocksize;
+    }
+
+    u32 NCZ::GetBlockCount()
+    {
+        return this->blocksizes.size();
+    }
+
+    u64 NCZ::GetBlockOffset(u32 Block)
+    {
+        return this->blockoffs[Block];
+    }
+
+    u64 NCZ::GetCompressedBlockSize(u32 Block)
+    {
+        return this->blocksizes[Block];
+    }
+
+    u64 NCZ::GetDataOffset()
+    {
+        return this->dataoff;
+    }
+
+    void NCZ::Encrypt(u64 Offset, u8 *Data, u64 Size)
+    {
+        for(auto &section: this->sections)
+        {
+            // Only AES-CTR (and BKTR, CTR too) sections were decrypted when compressing
+            if((section.CryptoType != 3) && (section.CryptoType != 4)) continue;
+            u64 start = std::max(Offset, section.Offset);
+            u64 end = std::min(Offset + Size, section.Offset + section.Size);
+            if(start >= end) continue;
+            u8 ctr[0x10] = {};
+            memcpy(ctr, section.CryptoCounter, 0x8);
+            u64 block = start >> 4;
+            for(u32 i = 0; i < 0x8; i++) ctr[0xF - i] = (u8)(block >> (8 * i));
+            Aes128CtrContext actx;
+            aes128CtrContextCreate(&actx, section.CryptoKey, ctr);
+            u64 skip = start & 0xF;
+            if(skip > 0)
+            {
+                u8 pad[0x10] = {};
+                aes128CtrCrypt(&actx, pad, pad, skip);
+            }
+            aes128CtrCrypt(&actx, Data + (start - Offset), Data + (start - Offset), end - start);
+        }
+    }
+}
@@ -0,0 +1,47 @@
+
+/*
+
+    Goldleaf - Multipurpose homebrew tool for Nintendo Switch
+    Copyright (C) 2018-2019  XorTroll
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+#include <nsp/nsp_XCI.hpp>
+
+namespace nsp
+{
+    HFS0::HFS0(fs::Explorer *Exp, String Path, u64 Offset) : ContentSource(Exp, Path)
+    {
+        this->ok = this->LoadPartition(Offset, HFS0Magic, sizeof(HFS0FileEntry));
+    }
+
+    std::unique_ptr<ContentSource> OpenXCI(fs::Explorer *Exp, String Path)
+    {
+        u32 magic = 0;
+        u64 rootoff = 0;
+        bool ok = (Exp->ReadFileBlock(Path, XCIMagicOffset, sizeof(magic), (u8*)&magic) == sizeof(magic)) && (magic == XCIMagic);
+        ok = ok && (Exp->ReadFileBlock(Path, XCIRootPartitionOffset, sizeof(rootoff), (u8*)&rootoff) == sizeof(rootoff));
+        if(ok)
+        {
+            HFS0 root(Exp, Path, rootoff);
+            auto idxsecure = root.GetFileIndexByName("secure");
+            if(root.IsOk() && idxsecure.has_value()) return std::make_unique<HFS0>(Exp, Path, root.GetFileOffset(idxsecure.value()));
+        }
+        // Not an XCI, or a broken one: an empty source which isn't ok
+        return std::make_unique<HFS0>(Exp, Path, 0);
+    }
+}
@@ -38,33 +38,83 @@ namespace ui
         this->Add(this->copyBar);
     }
 
-    void CopyLayout::StartCopy(String Path, String NewPath, bool Directory, fs::Explorer *Exp)
+    void CopyLayout::StartCopy(String Path, String NewPath, bool Directory, fs::Explorer *Exp, bool Move)
     {
+        // Pasting onto itself would delete the source before copying it
+        if(Path == NewPath) return;
+        auto cb = [&](double done, double total)
+        {
+            this->copyBar->SetMaxValue(total);
+            this->copyBar->SetProgress(done);
+            global_app->CallForRender();
+        };
         if(Directory)
         {
-            fs::CopyDirectoryProgress(Path, NewPath, [&](double done, double total)
+            if(Move)
             {
-                this->copyBar->SetMaxValue(total);
-                this->copyBar->SetProgress(done);
-                global_app->CallForRender();
-            });
-            global_app->ShowNotification(cfg::strings::Main.GetString(141));
+                auto rc = fs::MoveDirectoryProgress(Path, NewPath, cb, global_settings.copy_verify);
+                if(R_SUCCEEDED(rc)) global_app->ShowNotification(cfg::strings::Main.GetString(405));
+                else HandleResult(rc, cfg::strings::Main.GetString(406));
+                return;
+            }
+            auto rc = fs::CopyDirectoryProgress(Path, NewPath, cb, global_settings.copy_verify);
+            if(R_SUCCEEDED(rc)) global_app->ShowNotification(cfg::strings::Main.GetString(141));
+            else HandleResult(rc, cfg::strings::Main.GetString(403));
         }
         else
         {
-            if(Exp->IsFile(NewPath))
+            // A partial copy of this same file is resumed instead of being overwritten
+            if(!fs::CopyJournal::CanResume(Path, NewPath))
             {
-                int sopt = global_app->CreateShowDialog(cfg::strings::Main.GetString(153), cfg::strings::Main.GetString(143), { cfg::strings::Main.GetString(239), cfg::strings::Main.GetString(18) }, true);
-                if(sopt < 0) return;
+                if(Exp->IsFile(NewPath))
+                {
+                    int sopt = global_app->CreateShowDialog(cfg::strings::Main.GetString(153), cfg::strings::Main.GetString(143), { cfg::strings::Main.GetString(239), cfg::strings::Main.GetString(18) }, true);
+                    if(sopt < 0) return;
+                }
+                fs::DeleteFile(NewPath);
             }
-            fs::DeleteFile(NewPath);
-            fs::CopyFileProgress(Path, NewPath, [&](double done, double total)
+            if(Move)
             {
+                auto rc = fs::MoveFileProgress(Path, NewPath, cb, global_settings.copy_verify);
+                if(R_SUCCEEDED(rc)) global_app->ShowNotification(cfg::strings::Main.GetString(405));
+                else HandleResult(rc, cfg::strings::Main.GetString(406));
+                return;
+            }
+            auto rc = fs::CopyFileProgress(Path, NewPath, cb, global_settings.copy_verify);
+            if(R_SUCCEEDED(rc)) global_app->ShowNotification(cfg::strings::Main.GetString(240));
+            else HandleResult(rc, cfg::strings::Main.GetString(403));
+        }
+    }
+
+    fs::DedupReport CopyLayout::ScanDuplicates(String Dir, fs::Explorer *Exp)
+    {
+        auto cb = [&](fs::DedupStage stage, double done, double total)
+        {
+            switch(stage)
+            {
+                case fs::DedupStage::Listing:
+                    this->infoText->SetText(cfg::strings::Main.GetString(413) + " (" + std::to_string((u32)done) + ")");
+                    this->copyBar->SetVisible(false);
+                    break;
+                case fs::DedupStage::Partial:
+                    this->infoText->SetText(cfg::strings::Main.GetString(414));
+                    break;
+                case fs::DedupStage::Full:
+                    this->infoText->SetText(cfg::strings::Main.GetString(415));
+                    break;
+            }
+            if(stage != fs::DedupStage::Listing)
+            {
+                this->copyBar->SetVisible(true);
                 this->copyBar->SetMaxValue(total);
                 this->copyBar->SetProgress(done);
-                global_app->CallForRender();
-            });
-            global_app->ShowNotification(cfg::strings::Main.GetString(240));
-        }
+            }
+            global_app->CallForRender();
+        };
+        auto report = fs::FindDuplicates(Exp, Dir, cb);
+        this->infoText->SetText(cfg::strings::Main.GetString(151));
+        this->copyBar->SetVisible(true);
+        fs::SaveDedupReport(report);
+        return report;
     }
 }
\ No newline at end of file
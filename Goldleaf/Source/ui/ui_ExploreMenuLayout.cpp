@@ -56,12 +56,17 @@ namespace ui
         this->nandSystemMenuItem->SetIcon(global_settings.PathForResource("/Common/NAND.png"));
         this->nandSystemMenuItem->SetColor(global_settings.custom_scheme.Text);
         this->nandSystemMenuItem->AddOnClick(std::bind(&ExploreMenuLayout::nandSystem_Click, this));
+        this->searchMenuItem = pu::ui::elm::MenuItem::New(cfg::strings::Main.GetString(407));
+        this->searchMenuItem->SetIcon(global_settings.PathForResource("/Common/Storage.png"));
+        this->searchMenuItem->SetColor(global_settings.custom_scheme.Text);
+        this->searchMenuItem->AddOnClick(std::bind(&ExploreMenuLayout::search_Click, this));
         this->mountsMenu->AddItem(this->sdCardMenuItem);
         this->mountsMenu->AddItem(this->pcDriveMenuItem);
         this->mountsMenu->AddItem(this->nandProfInfoFMenuItem);
         this->mountsMenu->AddItem(this->nandSafeMenuItem);
         this->mountsMenu->AddItem(this->nandUserMenuItem);
         this->mountsMenu->AddItem(this->nandSystemMenuItem);
+        this->mountsMenu->AddItem(this->searchMenuItem);
         this->Add(this->mountsMenu);
     }
 
@@ -83,6 +88,13 @@ namespace ui
         global_app->LoadLayout(global_app->GetPCExploreLayout());
     }
 
+    void ExploreMenuLayout::search_Click()
+    {
+        if(!global_app->GetSearchLayout()->StartSearch()) return;
+        global_app->LoadMenuData(cfg::strings::Main.GetString(407), "Storage", cfg::strings::Main.GetString(278));
+        global_app->LoadLayout(global_app->GetSearchLayout());
+    }
+
     void ExploreMenuLayout::nandProdInfoF_Click()
     {
         global_app->GetBrowserLayout()->ChangePartitionNAND(fs::Partition::PRODINFOF);
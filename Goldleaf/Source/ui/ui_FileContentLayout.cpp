@@ -42,14 +42,16 @@ namespace ui
         this->mode = Hex;
         this->gexp = Exp;
         this->loffset = 0;
+        if(Hex) this->hview.Reset(Exp, Path);
+        else this->lindex.Reset(Exp, Path);
         this->Update();
     }
 
     void FileContentLayout::Update()
     {
         std::vector<String> lines;
-        if(this->mode) lines = this->gexp->ReadFileFormatHex(this->pth, this->loffset, 19);
-        else lines = this->gexp->ReadFileLines(this->pth, this->loffset, 19);
+        if(this->mode) lines = this->hview.ReadLines(this->loffset, 19);
+        else lines = this->lindex.ReadLines(this->loffset, 19);
         if(lines.empty())
         {
             this->loffset--;
@@ -80,4 +82,10 @@ namespace ui
         this->loffset++;
         this->Update();
     }
+
+    void FileContentLayout::UpdateIndex()
+    {
+        // The rest of the file gets indexed for a few milliseconds per frame while it's being viewed
+        if(!this->mode) this->lindex.Step();
+    }
 }
\ No newline at end of file
@@ -42,8 +42,18 @@ namespace ui
     void InstallLayout::StartInstall(String Path, fs::Explorer *Exp, Storage Location, bool OmitConfirmation)
     {
         nsp::Installer inst(Path, Exp, Location);
+        this->DoInstall(inst, OmitConfirmation, NULL, 0);
+    }
+
+    void InstallLayout::StartInstall(nsp::InstallQueue &Queue, u32 Index)
+    {
+        auto inst = Queue.Take(Index);
+        this->DoInstall(*inst, true, &Queue, Index);
+    }
 
-        auto rc = inst.PrepareInstallation();
+    void InstallLayout::DoInstall(nsp::Installer &Inst, bool OmitConfirmation, nsp::InstallQueue *Queue, u32 Index)
+    {
+        auto rc = Inst.PrepareInstallation();
         if(R_FAILED(rc))
         {
             if(rc == err::result::ResultTitleAlreadyInstalled)
@@ -51,12 +61,12 @@ namespace ui
                 auto sopt = global_app->CreateShowDialog(cfg::strings::Main.GetString(77), cfg::strings::Main.GetString(272) + "\n" + cfg::strings::Main.GetString(273) + "\n" + cfg::strings::Main.GetString(274), { cfg::strings::Main.GetString(111), cfg::strings::Main.GetString(18) }, true);
                 if(sopt == 0)
                 {
-                    auto title = hos::Locate(inst.GetApplicationId());
-                    if(title.ApplicationId == inst.GetApplicationId())
+                    auto title = hos::Locate(Inst.GetApplicationId());
+                    if(title.ApplicationId == Inst.GetApplicationId())
                     {
                         hos::RemoveTitle(title);
-                        inst.FinalizeInstallation();
-                        auto rc = inst.PrepareInstallation();
+                        Inst.FinalizeInstallation();
+                        auto rc = Inst.PrepareInstallation();
                         if(R_FAILED(rc))
                         {
                             HandleResult(rc, cfg::strings::Main.GetString(251));
@@ -82,7 +92,7 @@ namespace ui
         else
         {
             String info = cfg::strings::Main.GetString(82) + "\n\n";
-            switch(inst.GetContentMetaType())
+            switch(Inst.GetContentMetaType())
             {
                 case ncm::ContentMetaType::Application:
                     info += cfg::strings::Main.GetString(83);
@@ -98,7 +108,7 @@ namespace ui
                     break;
             }
             info += "\n";
-            hos::ApplicationIdMask idmask = hos::IsValidApplicationId(inst.GetApplicationId());
+            hos::ApplicationIdMask idmask = hos::IsValidApplicationId(Inst.GetApplicationId());
             switch(idmask)
             {
                 case hos::ApplicationIdMask::Official:
@@ -111,9 +121,9 @@ namespace ui
                     info += cfg::strings::Main.GetString(89);
                     break;
             }
-            info += "\n" + cfg::strings::Main.GetString(90) + " " + hos::FormatApplicationId(inst.GetApplicationId());
+            info += "\n" + cfg::strings::Main.GetString(90) + " " + hos::FormatApplicationId(Inst.GetApplicationId());
             info += "\n\n";
-            auto NACP = inst.GetNACP();
+            auto NACP = Inst.GetNACP();
             if(NACP->display_version[0] != '\0')
             {
                 NacpLanguageEntry *lent;
@@ -131,7 +141,7 @@ namespace ui
                 info += NACP->display_version;
                 info += "\n\n";
             }
-            auto NCAs = inst.GetNCAs();
+            auto NCAs = Inst.GetNCAs();
             info += cfg::strings::Main.GetString(93) + " ";
             for(u32 i = 0; i < NCAs.size(); i++)
             {
@@ -162,7 +172,7 @@ namespace ui
                 if(i != (NCAs.size() - 1)) info += ", ";
             }
 
-            u8 kgen = inst.GetKeyGeneration();
+            u8 kgen = Inst.GetKeyGeneration();
             u8 masterkey = kgen - 1;
             info += "\n" + cfg::strings::Main.GetString(95) + " " + std::to_string(kgen) + " ";
             switch(masterkey)
@@ -202,9 +212,9 @@ namespace ui
                     break;
             }
 
-            if(inst.HasTicket())
+            if(Inst.HasTicket())
             {
-                auto Tik = inst.GetTicketData();
+                auto Tik = Inst.GetTicketData();
                 info += "\n\n" + cfg::strings::Main.GetString(94) + "\n\n";
                 info += cfg::strings::Main.GetString(235) + " " + Tik.TitleKey;
                 info += "\n" + cfg::strings::Main.GetString(236) + " ";
@@ -233,14 +243,14 @@ namespace ui
                 }
             }
             else info += "\n\n" + cfg::strings::Main.GetString(97);
-            int sopt = global_app->CreateShowDialog(cfg::strings::Main.GetString(77), info, { cfg::strings::Main.GetString(65), cfg::strings::Main.GetString(18) }, true, inst.GetExportedIconPath());
+            int sopt = global_app->CreateShowDialog(cfg::strings::Main.GetString(77), info, { cfg::strings::Main.GetString(65), cfg::strings::Main.GetString(18) }, true, Inst.GetExportedIconPath());
 
             doinstall = (sopt == 0);
         }
         
         if(doinstall)
         {
-            rc = inst.PreProcessContents();
+            rc = Inst.PreProcessContents();
             if(R_FAILED(rc))
             {
                 HandleResult(rc, cfg::strings::Main.GetString(251));
@@ -250,23 +260,36 @@ namespace ui
             global_app->CallForRender();
             this->installBar->SetVisible(true);
             hos::LockAutoSleep();
-            rc = inst.WriteContents([&](ncm::ContentRecord Record, u32 Content, u32 ContentCount, double Done, double Total, u64 BytesSec)
+            // The next packages of a batch get parsed while this one writes
+            if(Queue != NULL) Queue->StartPrefetch();
+            rc = Inst.WriteContents([&](ncm::ContentRecord Record, u32 Content, u32 ContentCount, double Done, double Total, u64 BytesSec)
             {
                 this->installBar->SetMaxValue(Total);
                 String name = cfg::strings::Main.GetString(148) + " \'"  + hos::ContentIdAsString(Record.ContentId);
                 if(Record.Type == ncm::ContentType::Meta) name += ".cnmt";
                 u64 speed = (u64)BytesSec;
                 u64 size = (u64)(Total - Done);
-                u64 secstime = size / speed;
+                u64 secstime = (speed > 0) ? (size / speed) : 0;
                 name += ".nca\'... (" + fs::FormatSize(BytesSec) + "/s  -  " + hos::FormatTime(secstime) + ")";
+                if(Queue != NULL)
+                {
+                    // Packages are weighted by their file size, which is close enough to what gets written
+                    u64 pkgsize = Queue->GetPackageSize(Index);
+                    u64 pkgdone = (Total > 0) ? (u64)((Done / Total) * pkgsize) : 0;
+                    u64 totalleft = Queue->GetTotalSize() - std::min(Queue->GetTotalSize(), Queue->GetSizeBefore(Index) + pkgdone);
+                    u64 totalsecs = (speed > 0) ? (totalleft / speed) : 0;
+                    name += "\n" + cfg::strings::Main.GetString(422) + " " + std::to_string(Index + 1) + "/" + std::to_string(Queue->GetCount()) + "  -  " + cfg::strings::Main.GetString(423) + " " + hos::FormatTime(totalsecs);
+                }
                 this->installText->SetText(name);
                 this->installBar->SetProgress(Done);
                 global_app->CallForRender();
             });
+            if(Queue != NULL) Queue->StopPrefetch();
             hos::UnlockAutoSleep();
         }
         this->installBar->SetVisible(false);
         global_app->CallForRender();
+        fs::SaveIoStats();
         if(R_FAILED(rc)) HandleResult(rc, cfg::strings::Main.GetString(251));
         else if(doinstall) global_app->ShowNotification(cfg::strings::Main.GetString(150));
     }
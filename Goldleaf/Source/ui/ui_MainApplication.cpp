@@ -106,6 +106,8 @@ namespace ui
         this->exploreMenu->SetOnInput(std::bind(&MainApplication::exploreMenu_Input, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
         this->pcExplore = PCExploreLayout::New();
         this->pcExplore->SetOnInput(std::bind(&MainApplication::pcExplore_Input, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
+        this->search = SearchLayout::New();
+        this->search->SetOnInput(std::bind(&MainApplication::search_Input, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
         this->nspInstall = InstallLayout::New();
         this->contentInformation = ContentInformationLayout::New();
         this->contentInformation->SetOnInput(std::bind(&MainApplication::contentInformation_Input, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
@@ -134,6 +136,7 @@ namespace ui
         MAINAPP_MENU_SET_BASE(this->browser);
         MAINAPP_MENU_SET_BASE(this->exploreMenu);
         MAINAPP_MENU_SET_BASE(this->pcExplore);
+        MAINAPP_MENU_SET_BASE(this->search);
         MAINAPP_MENU_SET_BASE(this->fileContent);
         MAINAPP_MENU_SET_BASE(this->copy);
         MAINAPP_MENU_SET_BASE(this->emuiibo);
@@ -154,6 +157,13 @@ namespace ui
         // Special extras
         this->mainMenu->Add(this->menuBanner);
 
+        // The index loads and walks these on its own thread
+        auto &index = fs::GetFileIndex();
+        index.AddRoot(fs::GetSdCardExplorer()->GetMountName() + ":/");
+        index.AddRoot(fs::GetNANDSafeExplorer()->GetMountName() + ":/");
+        index.AddRoot(fs::GetNANDUserExplorer()->GetMountName() + ":/");
+        index.AddRoot(fs::GetNANDSystemExplorer()->GetMountName() + ":/");
+
         this->AddThread(std::bind(&MainApplication::UpdateValues, this));
         this->SetOnInput(std::bind(&MainApplication::OnInput, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
         this->LoadLayout(this->mainMenu);
@@ -291,6 +301,7 @@ namespace ui
 
     void MainApplication::browser_Input(u64 down, u64 up, u64 held)
     {
+        this->browser->UpdateVisibleElements();
         if(down & KEY_B)
         {
             if(this->browser->GoBack()) this->browser->UpdateElements(-1);
@@ -311,7 +322,7 @@ namespace ui
                 else
                 {
                     String ext = fs::GetExtension(clipboard);
-                    if(ext == "nsp") fsicon = global_settings.PathForResource("/FileSystem/NSP.png");
+                    if(nsp::IsPackageExtension(ext)) fsicon = global_settings.PathForResource("/FileSystem/NSP.png");
                     else if(ext == "nro") fsicon = global_settings.PathForResource("/FileSystem/NRO.png");
                     else if(ext == "tik") fsicon = global_settings.PathForResource("/FileSystem/TIK.png");
                     else if(ext == "cert") fsicon = global_settings.PathForResource("/FileSystem/CERT.png");
@@ -319,12 +330,13 @@ namespace ui
                     else if(ext == "nxtheme") fsicon = global_settings.PathForResource("/FileSystem/NXTheme.png");
                     else fsicon = global_settings.PathForResource("/FileSystem/File.png");
                 }
-                int sopt = this->CreateShowDialog(cfg::strings::Main.GetString(222), cfg::strings::Main.GetString(223) + "\n(" + clipboard + ")", { cfg::strings::Main.GetString(111), cfg::strings::Main.GetString(18) }, true, fsicon);
-                if(sopt == 0)
+                int sopt = this->CreateShowDialog(cfg::strings::Main.GetString(222), cfg::strings::Main.GetString(223) + "\n(" + clipboard + ")", { cfg::strings::Main.GetString(111), cfg::strings::Main.GetString(404), cfg::strings::Main.GetString(18) }, true, fsicon);
+                if((sopt == 0) || (sopt == 1))
                 {
                     String cname = fs::GetFileName(clipboard);
                     this->LoadLayout(this->GetCopyLayout());
-                    this->GetCopyLayout()->StartCopy(clipboard, this->browser->GetExplorer()->FullPathFor(cname), cdir, this->browser->GetExplorer());
+                    this->GetCopyLayout()->StartCopy(clipboard, this->browser->GetExplorer()->FullPathFor(cname), cdir, this->browser->GetExplorer(), (sopt == 1));
+                    fs::SaveIoStats();
                     global_app->LoadLayout(this->browser);
                     this->browser->UpdateElements();
                     clipboard = "";
@@ -391,8 +403,19 @@ namespace ui
         }
     }
 
+    void MainApplication::search_Input(u64 down, u64 up, u64 held)
+    {
+        if(down & KEY_B)
+        {
+            this->UnloadMenuData();
+            this->LoadMenuData(cfg::strings::Main.GetString(277), "Storage", cfg::strings::Main.GetString(278));
+            this->LoadLayout(this->exploreMenu);
+        }
+    }
+
     void MainApplication::fileContent_Input(u64 down, u64 up, u64 held)
     {
+        this->fileContent->UpdateIndex();
         if(down & KEY_B) this->LoadLayout(this->browser);
         else if((down & KEY_DDOWN) || (down & KEY_LSTICK_DOWN) || (held & KEY_RSTICK_DOWN)) this->fileContent->ScrollDown();
         else if((down & KEY_DUP) || (down & KEY_LSTICK_UP) || (held & KEY_RSTICK_UP)) this->fileContent->ScrollUp();
@@ -517,6 +540,11 @@ namespace ui
         return this->pcExplore;
     }
 
+    SearchLayout::Ref &MainApplication::GetSearchLayout()
+    {
+        return this->search;
+    }
+
     InstallLayout::Ref &MainApplication::GetInstallLayout()
     {
         return this->nspInstall;
@@ -94,6 +94,8 @@ namespace ui
     {
         u32 idx = this->pathsMenu->GetSelectedIndex();
         global_app->GetBrowserLayout()->ChangePartitionPCDrive(this->paths[idx]);
+        // Browsed PC locations get indexed too, and stay searchable while disconnected
+        fs::GetFileIndex().AddRoot(global_app->GetBrowserLayout()->GetExplorer()->GetCwd());
         global_app->LoadLayout(global_app->GetBrowserLayout());
     }
 
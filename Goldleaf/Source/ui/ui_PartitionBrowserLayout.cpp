@@ -29,9 +29,15 @@ namespace ui
 {
     std::vector<u32> expidxstack;
 
+    // Time spent listing a folder per frame, so that huge ones don't freeze the browser
+    static constexpr u64 ListingFrameBudgetNs = 8000000;
+
     PartitionBrowserLayout::PartitionBrowserLayout() : pu::ui::Layout()
     {
         this->gexp = fs::GetSdCardExplorer();
+        this->elemsdone = true;
+        this->elemssorted = 0;
+        this->elemsshown = 0;
         this->browseMenu = pu::ui::elm::Menu::New(0, 160, 1280, global_settings.custom_scheme.Base, global_settings.menu_item_size, (560 / global_settings.menu_item_size));
         this->browseMenu->SetOnFocusColor(global_settings.custom_scheme.BaseFocus);
         global_settings.ApplyScrollBarColor(this->browseMenu);
@@ -77,12 +83,23 @@ namespace ui
         if(Update) this->UpdateElements();
     }
 
+    void PartitionBrowserLayout::ChangePartitionExplorer(fs::Explorer *Exp, bool Update)
+    {
+        this->gexp = Exp;
+        if(Update) this->UpdateElements();
+    }
+
     void PartitionBrowserLayout::UpdateElements(int Idx)
     {
         if(!this->elems.empty()) this->elems.clear();
-        this->elems = this->gexp->GetContents();
+        this->elemsdone = false;
+        this->elemssorted = 0;
+        this->elemsshown = 0;
         this->browseMenu->ClearItems();
         global_app->LoadMenuHead(this->gexp->GetPresentableCwd());
+        this->gexp->StartDirectory(this->gexp->GetCwd());
+        // Most folders are fully listed within the budget, bigger ones show their first block and finish in the next frames
+        this->LoadElements(ListingFrameBudgetNs);
         if(this->elems.empty())
         {
             this->browseMenu->SetVisible(false);
@@ -92,29 +109,6 @@ namespace ui
         {
             this->browseMenu->SetVisible(true);
             this->dirEmptyText->SetVisible(false);
-            for(auto &itm: this->elems)
-            {
-                bool isdir = this->gexp->IsDirectory(itm);
-                auto mitm = pu::ui::elm::MenuItem::New(itm);
-                mitm->SetColor(global_settings.custom_scheme.Text);
-                if(isdir) mitm->SetIcon(global_settings.PathForResource("/FileSystem/Directory.png"));
-                else
-                {
-                    String ext = fs::GetExtension(itm);
-                    if(ext == "nsp") mitm->SetIcon(global_settings.PathForResource("/FileSystem/NSP.png"));
-                    else if(ext == "nro") mitm->SetIcon(global_settings.PathForResource("/FileSystem/NRO.png"));
-                    else if(ext == "tik") mitm->SetIcon(global_settings.PathForResource("/FileSystem/TIK.png"));
-                    else if(ext == "cert") mitm->SetIcon(global_settings.PathForResource("/FileSystem/CERT.png"));
-                    else if(ext == "nxtheme") mitm->SetIcon(global_settings.PathForResource("/FileSystem/NXTheme.png"));
-                    else if(ext == "nca") mitm->SetIcon(global_settings.PathForResource("/FileSystem/NCA.png"));
-                    else if(ext == "nacp") mitm->SetIcon(global_settings.PathForResource("/FileSystem/NACP.png"));
-                    else if((ext == "jpg") || (ext == "jpeg")) mitm->SetIcon(global_settings.PathForResource("/FileSystem/JPEG.png"));
-                    else mitm->SetIcon(global_settings.PathForResource("/FileSystem/File.png"));
-                }
-                mitm->AddOnClick(std::bind(&PartitionBrowserLayout::fsItems_Click, this, itm));
-                mitm->AddOnClick(std::bind(&PartitionBrowserLayout::fsItems_Click_Y, this, itm), KEY_Y);
-                this->browseMenu->AddItem(mitm);
-            }
             u32 tmpidx = 0;
             if(Idx < 0)
             {
@@ -124,12 +118,101 @@ namespace ui
                     expidxstack.pop_back();
                 }
             }
+            else tmpidx = Idx;
+            // A kept index refers to the fully sorted listing
+            if(tmpidx > 0) this->LoadElements(0);
+            if(this->elems.size() <= tmpidx) tmpidx = 0;
+            this->ShowElements(tmpidx + (560 / global_settings.menu_item_size) + fs::DirectoryBlockSize);
+            this->browseMenu->SetSelectedIndex(tmpidx);
+        }
+    }
+
+    bool PartitionBrowserLayout::LoadElements(u64 BudgetNs)
+    {
+        if(this->elemsdone) return true;
+        u64 start = armGetSystemTick();
+        do
+        {
+            if(this->gexp->ReadDirectoryBlock(fs::DirectoryBlockSize, this->elems) < fs::DirectoryBlockSize)
+            {
+                this->elemsdone = true;
+                this->gexp->EndDirectory();
+            }
+        } while(!this->elemsdone && ((BudgetNs == 0) || (armTicksToNs(armGetSystemTick() - start) < BudgetNs)));
+        if(this->elemsdone)
+        {
+            // Sorted once over the whole listing, then the shown items get rebuilt keeping the selected entry
+            String selname;
+            if(this->elemsshown > 0) selname = this->elems[this->browseMenu->GetSelectedIndex()].Name;
+            fs::SortDirectoryEntries(this->elems.begin(), this->elems.end(), global_settings.natural_sort);
+            this->elemssorted = this->elems.size();
+            if(this->elemsshown > 0)
+            {
+                u32 selidx = 0;
+                auto it = std::find_if(this->elems.begin(), this->elems.end(), [&](fs::DirectoryEntry &ent) -> bool
+                {
+                    return (ent.Name == selname);
+                });
+                if(it != this->elems.end()) selidx = std::distance(this->elems.begin(), it);
+                u32 showcount = std::max(this->elemsshown, selidx + (560 / global_settings.menu_item_size));
+                this->browseMenu->ClearItems();
+                this->elemsshown = 0;
+                this->ShowElements(showcount);
+                this->browseMenu->SetSelectedIndex(selidx);
+            }
+        }
+        else if(this->elemssorted == 0)
+        {
+            // Only the first block gets shown while the rest is being listed
+            this->elemssorted = std::min((u32)this->elems.size(), fs::DirectoryBlockSize);
+            fs::SortDirectoryEntries(this->elems.begin(), this->elems.begin() + this->elemssorted, global_settings.natural_sort);
+        }
+        return this->elemsdone;
+    }
+
+    void PartitionBrowserLayout::ShowElements(u32 Count)
+    {
+        for(; (this->elemsshown < Count) && (this->elemsshown < this->elemssorted); this->elemsshown++)
+        {
+            auto &itm = this->elems[this->elemsshown];
+            auto mitm = pu::ui::elm::MenuItem::New(itm.Name);
+            mitm->SetColor(global_settings.custom_scheme.Text);
+            if(itm.IsDirectory) mitm->SetIcon(global_settings.PathForResource("/FileSystem/Directory.png"));
             else
             {
-                if(this->elems.size() > (u32)Idx) tmpidx = Idx;
+                String ext = fs::GetExtension(itm.Name);
+                if(nsp::IsPackageExtension(ext)) mitm->SetIcon(global_settings.PathForResource("/FileSystem/NSP.png"));
+                else if(ext == "nro") mitm->SetIcon(global_settings.PathForResource("/FileSystem/NRO.png"));
+                else if(ext == "tik") mitm->SetIcon(global_settings.PathForResource("/FileSystem/TIK.png"));
+                else if(ext == "cert") mitm->SetIcon(global_settings.PathForResource("/FileSystem/CERT.png"));
+                else if(ext == "nxtheme") mitm->SetIcon(global_settings.PathForResource("/FileSystem/NXTheme.png"));
+                else if(ext == "nca") mitm->SetIcon(global_settings.PathForResource("/FileSystem/NCA.png"));
+                else if(ext == "nacp") mitm->SetIcon(global_settings.PathForResource("/FileSystem/NACP.png"));
+                else if((ext == "jpg") || (ext == "jpeg")) mitm->SetIcon(global_settings.PathForResource("/FileSystem/JPEG.png"));
+                else mitm->SetIcon(global_settings.PathForResource("/FileSystem/File.png"));
             }
-            this->browseMenu->SetSelectedIndex(tmpidx);
+            mitm->AddOnClick(std::bind(&PartitionBrowserLayout::fsItems_Click, this, itm.Name));
+            mitm->AddOnClick(std::bind(&PartitionBrowserLayout::fsItems_Click_Y, this, itm.Name), KEY_Y);
+            this->browseMenu->AddItem(mitm);
+        }
+    }
+
+    void PartitionBrowserLayout::UpdateVisibleElements()
+    {
+        // Keep listing in the background, and at least one more screen of items created past the selected one
+        if(this->elems.empty()) return;
+        u32 showcount = 560 / global_settings.menu_item_size;
+        u32 selidx = this->browseMenu->GetSelectedIndex();
+        bool needmore = ((selidx + showcount) >= this->elemsshown);
+        if(!this->elemsdone) this->LoadElements(ListingFrameBudgetNs);
+        if(!needmore) return;
+        // Scrolling doesn't wait for the listing to finish: what was listed so far gets sorted after the shown items, which keep their place until the final sort
+        if(!this->elemsdone && (this->elemssorted < this->elems.size()))
+        {
+            fs::SortDirectoryEntries(this->elems.begin() + this->elemssorted, this->elems.end(), global_settings.natural_sort);
+            this->elemssorted = this->elems.size();
         }
+        this->ShowElements(this->elemsshown + fs::DirectoryBlockSize);
     }
 
     void PartitionBrowserLayout::HandleFileDirectly(String Path)
@@ -137,15 +220,14 @@ namespace ui
         auto dir = fs::GetBaseDirectory(Path);
         auto fname = fs::GetFileName(Path);
         this->ChangePartitionPCDrive(dir);
-
-        auto items = this->browseMenu->GetItems();
-        auto it = std::find_if(items.begin(), items.end(), [&](pu::ui::elm::MenuItem::Ref &item) -> bool
+        this->LoadElements(0);
+        auto it = std::find_if(this->elems.begin(), this->elems.end(), [&](fs::DirectoryEntry &ent) -> bool
         {
-            return (item->GetName() == fname);
+            return (ent.Name == fname);
         });
-        if(it == items.end()) return;
-
-        u32 idx = std::distance(items.begin(), it);
+        if(it == this->elems.end()) return;
+        u32 idx = std::distance(this->elems.begin(), it);
+        this->ShowElements(idx + (560 / global_settings.menu_item_size));
         this->browseMenu->SetSelectedIndex(idx);
         fsItems_Click(fname);
     }
@@ -176,7 +258,7 @@ namespace ui
         {
             String ext = fs::GetExtension(item);
             String msg = cfg::strings::Main.GetString(52) + " ";
-            if(ext == "nsp") msg += cfg::strings::Main.GetString(53);
+            if(nsp::IsPackageExtension(ext)) msg += cfg::strings::Main.GetString(53);
             else if(ext == "nro") msg += cfg::strings::Main.GetString(54);
             else if(ext == "tik") msg += cfg::strings::Main.GetString(55);
             else if(ext == "nxtheme") msg += cfg::strings::Main.GetString(56);
@@ -188,7 +270,7 @@ namespace ui
             std::vector<String> vopts;
             u32 copt = 5;
             bool ibin = this->gexp->IsFileBinary(fullitm);
-            if(ext == "nsp")
+            if(nsp::IsPackageExtension(ext))
             {
                 vopts.push_back(cfg::strings::Main.GetString(65));
                 copt = 6;
@@ -239,7 +321,7 @@ namespace ui
             int sopt = global_app->CreateShowDialog(cfg::strings::Main.GetString(76), msg, vopts, true);
             if(sopt < 0) return;
             int osopt = sopt;
-            if(ext == "nsp")
+            if(nsp::IsPackageExtension(ext))
             {
                 switch(sopt)
                 {
@@ -330,17 +412,13 @@ namespace ui
                 switch(sopt)
                 {
                     case 0:
-                        NacpStruct nacp = {};
-                        auto fsize = this->gexp->GetFileSize(fullitm);
-                        if(fsize < sizeof(NacpStruct))
+                        auto view = this->gexp->OpenView(fullitm);
+                        NacpStruct *snacp = (NacpStruct*)view.GetAs<NacpStruct>(0);
+                        if(snacp == NULL)
                         {
                             global_app->ShowNotification(cfg::strings::Main.GetString(341));
                             return;
                         }
-                        this->gexp->StartFile(fullitm, fs::FileMode::Read);
-                        this->gexp->ReadFileBlock(fullitm, 0, sizeof(NacpStruct), (u8*)&nacp);
-                        this->gexp->EndFile(fs::FileMode::Read);
-                        NacpStruct *snacp = &nacp;
                         u8 *rnacp = (u8*)snacp;
                         NacpLanguageEntry *lent = NULL;
                         nacpGetLanguageEntry(snacp, &lent);
@@ -391,16 +469,14 @@ namespace ui
                         sopt = global_app->CreateShowDialog(cfg::strings::Main.GetString(121), cfg::strings::Main.GetString(122), { cfg::strings::Main.GetString(111), cfg::strings::Main.GetString(18) }, true);
                         if(sopt < 0) return;
 
-                        size_t fsize = this->gexp->GetFileSize(fullitm);
-                        u8 *iconbuf = new u8[fsize]();
-                        this->gexp->StartFile(fullitm, fs::FileMode::Read);
-                        this->gexp->ReadFileBlock(fullitm, 0, fsize, iconbuf);
-                        this->gexp->EndFile(fs::FileMode::Read);
+                        auto view = this->gexp->OpenView(fullitm);
+                        size_t fsize = view.GetSize();
+                        auto iconbuf = (u8*)view.Get(0, fsize);
+                        if(iconbuf == NULL) return;
 
                         auto rc = acc::EditUserIcon(iconbuf, fsize);
                         if(R_SUCCEEDED(rc)) global_app->ShowNotification(cfg::strings::Main.GetString(123));
                         else HandleResult(rc, cfg::strings::Main.GetString(124));
-                        delete[] iconbuf;
                         break;
                 }
             }
@@ -460,9 +536,8 @@ namespace ui
                     if(this->gexp->IsFile(newren) || this->gexp->IsDirectory(newren)) HandleResult(err::result::ResultEntryAlreadyPresent, cfg::strings::Main.GetString(254));
                     else if(this->WarnNANDWriteAccess())
                     {
-                        int rc = 0;
-                        this->gexp->RenameFile(fullitm, newren);
-                        if(rc) HandleResult(err::result::MakeErrnoResult(), cfg::strings::Main.GetString(254));
+                        auto rc = this->gexp->RenameFile(fullitm, newren);
+                        if(R_FAILED(rc)) HandleResult(rc, cfg::strings::Main.GetString(254));
                         else
                         {
                             global_app->ShowNotification(cfg::strings::Main.GetString(133));
@@ -485,9 +560,9 @@ namespace ui
             for(u32 i = 0; i < files.size(); i++)
             {
                 auto path = fullitm + "/" + files[i];
-                if(fs::GetExtension(path) == "nsp") nsps.push_back(files[i]);
+                if(nsp::IsPackageExtension(fs::GetExtension(path))) nsps.push_back(files[i]);
             }
-            std::vector<String> extraopts = { cfg::strings::Main.GetString(281) };
+            std::vector<String> extraopts = { cfg::strings::Main.GetString(281), cfg::strings::Main.GetString(412) };
             if(!nsps.empty()) extraopts.push_back(cfg::strings::Main.GetString(282));
             extraopts.push_back(cfg::strings::Main.GetString(18));
             String msg = cfg::strings::Main.GetString(134);
@@ -519,9 +594,8 @@ namespace ui
                             if(this->gexp->IsFile(newren) || this->gexp->IsDirectory(newren)) HandleResult(err::result::ResultEntryAlreadyPresent, cfg::strings::Main.GetString(254));
                             else if(this->WarnNANDWriteAccess())
                             {
-                                int rc = 0;
-                                this->gexp->RenameDirectory(fullitm, newren);
-                                if(rc) HandleResult(rc, cfg::strings::Main.GetString(254));
+                                auto rc = this->gexp->RenameDirectory(fullitm, newren);
+                                if(R_FAILED(rc)) HandleResult(rc, cfg::strings::Main.GetString(254));
                                 else global_app->ShowNotification(cfg::strings::Main.GetString(139));
                                 this->UpdateElements();
                             }
@@ -538,26 +612,56 @@ namespace ui
                             global_app->ShowNotification(cfg::strings::Main.GetString(303));
                             break;
                         case 1:
+                            {
+                                global_app->LoadMenuHead(cfg::strings::Main.GetString(412) + " " + pfullitm);
+                                global_app->LoadLayout(global_app->GetCopyLayout());
+                                auto report = global_app->GetCopyLayout()->ScanDuplicates(fullitm, this->gexp);
+                                global_app->LoadLayout(global_app->GetBrowserLayout());
+                                global_app->LoadMenuHead(this->gexp->GetPresentableCwd());
+                                if(report.Groups.empty())
+                                {
+                                    global_app->ShowNotification(cfg::strings::Main.GetString(416));
+                                    break;
+                                }
+                                String msg = cfg::strings::Main.GetString(417) + " " + std::to_string(report.Groups.size());
+                                msg += "\n" + cfg::strings::Main.GetString(418) + " " + fs::FormatSize(report.ReclaimableSize);
+                                msg += "\n\n" + cfg::strings::Main.GetString(419);
+                                sopt = global_app->CreateShowDialog(cfg::strings::Main.GetString(412), msg, { cfg::strings::Main.GetString(420), cfg::strings::Main.GetString(18) }, true);
+                                if(sopt != 0) break;
+                                if(this->WarnNANDWriteAccess())
+                                {
+                                    fs::DeleteDuplicates(this->gexp, report);
+                                    global_app->ShowNotification(cfg::strings::Main.GetString(421));
+                                    this->UpdateElements(this->browseMenu->GetSelectedIndex());
+                                }
+                            }
+                            break;
+                        case 2:
+                            // Only there if the directory has NSPs, otherwise it's the cancel option
+                            if(nsps.empty()) break;
                             sopt = global_app->CreateShowDialog(cfg::strings::Main.GetString(77), cfg::strings::Main.GetString(78), { cfg::strings::Main.GetString(19), cfg::strings::Main.GetString(79), cfg::strings::Main.GetString(18) }, true);
                             if(sopt < 0) return;
                             Storage dst = Storage::SdCard;
                             if(sopt == 0) dst = Storage::SdCard;
                             else if(sopt == 1) dst = Storage::NANDUser;
-                            for(u32 i = 0; i < nsps.size(); i++)
+                            std::vector<String> nsppaths;
+                            for(auto &name: nsps) nsppaths.push_back(fullitm + "/" + name);
                             {
-                                auto nsp = fullitm + "/" + nsps[i];
-                                auto pnsp = pfullitm + "/" + nsps[i];
-                                
-                                u64 fsize = this->gexp->GetFileSize(nsp);
-                                u64 rsize = fs::GetFreeSpaceForPartition(static_cast<fs::Partition>(dst));
-                                if(rsize < fsize)
+                                nsp::InstallQueue queue(nsppaths, this->gexp, dst);
+                                global_app->LoadLayout(global_app->GetInstallLayout());
+                                for(u32 i = 0; i < queue.GetCount(); i++)
                                 {
-                                    HandleResult(err::result::ResultNotEnoughSize, cfg::strings::Main.GetString(251));
-                                    return;
+                                    auto pnsp = pfullitm + "/" + nsps[i];
+                                    u64 fsize = queue.GetPackageSize(i);
+                                    u64 rsize = fs::GetFreeSpaceForPartition(static_cast<fs::Partition>(dst));
+                                    if(rsize < fsize)
+                                    {
+                                        HandleResult(err::result::ResultNotEnoughSize, cfg::strings::Main.GetString(251));
+                                        break;
+                                    }
+                                    global_app->LoadMenuHead(cfg::strings::Main.GetString(145) + " " + pnsp);
+                                    global_app->GetInstallLayout()->StartInstall(queue, i);
                                 }
-                                global_app->LoadMenuHead(cfg::strings::Main.GetString(145) + " " + pnsp);
-                                global_app->LoadLayout(global_app->GetInstallLayout());
-                                global_app->GetInstallLayout()->StartInstall(nsp, this->gexp, dst, true);
                                 global_app->LoadLayout(global_app->GetBrowserLayout());
                             }
                             global_app->LoadMenuHead(this->gexp->GetPresentableCwd());
@@ -0,0 +1,97 @@
+
+/*
+
+    Goldleaf - Multipurpose homebrew tool for Nintendo Switch
+    Copyright (C) 2018-2019  XorTroll
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+#include <ui/ui_SearchLayout.hpp>
+#include <ui/ui_MainApplication.hpp>
+
+extern ui::MainApplication::Ref global_app;
+extern cfg::Settings global_settings;
+
+namespace ui
+{
+    // Enough to fill several screens, more than that means the query should be narrowed down
+    static constexpr u32 MaxSearchResults = 0x100;
+
+    SearchLayout::SearchLayout() : pu::ui::Layout()
+    {
+        this->resultsMenu = pu::ui::elm::Menu::New(0, 160, 1280, global_settings.custom_scheme.Base, global_settings.menu_item_size, (560 / global_settings.menu_item_size));
+        this->resultsMenu->SetOnFocusColor(global_settings.custom_scheme.BaseFocus);
+        global_settings.ApplyScrollBarColor(this->resultsMenu);
+        this->Add(this->resultsMenu);
+    }
+
+    bool SearchLayout::StartSearch()
+    {
+        String query = AskForText(cfg::strings::Main.GetString(408), "");
+        if(query == "") return false;
+        auto &index = fs::GetFileIndex();
+        auto found = index.Search(query, MaxSearchResults);
+        if(found.empty())
+        {
+            String msg = cfg::strings::Main.GetString(409);
+            if(index.IsIndexing()) msg += "\n" + cfg::strings::Main.GetString(410);
+            global_app->CreateShowDialog(cfg::strings::Main.GetString(407), msg, { cfg::strings::Main.GetString(234) }, true);
+            return false;
+        }
+        if(index.IsIndexing()) global_app->ShowNotification(cfg::strings::Main.GetString(410));
+        this->results.clear();
+        this->resultsMenu->ClearItems();
+        for(auto &res: found)
+        {
+            auto itm = pu::ui::elm::MenuItem::New(res.Path + " (" + fs::FormatSize(res.Size) + ")");
+            itm->SetColor(global_settings.custom_scheme.Text);
+            itm->SetIcon(global_settings.PathForResource("/FileSystem/File.png"));
+            itm->AddOnClick(std::bind(&SearchLayout::result_Click, this));
+            this->resultsMenu->AddItem(itm);
+            this->results.push_back(res.Path);
+        }
+        this->resultsMenu->SetSelectedIndex(0);
+        return true;
+    }
+
+    void SearchLayout::result_Click()
+    {
+        auto &path = this->results[this->resultsMenu->GetSelectedIndex()];
+        String dir = fs::GetBaseDirectory(path);
+        if(dir.substr(dir.length() - 1) == ":") dir += "/";
+        auto browser = global_app->GetBrowserLayout();
+        auto exp = fs::GetExplorerForPath(dir);
+        if(exp != NULL)
+        {
+            if(!exp->NavigateForward(dir))
+            {
+                global_app->CreateShowDialog(cfg::strings::Main.GetString(407), cfg::strings::Main.GetString(411), { cfg::strings::Main.GetString(234) }, true);
+                return;
+            }
+            browser->ChangePartitionExplorer(exp);
+        }
+        // Only PC drives aren't always mounted
+        else if(usb::detail::IsStateOk()) browser->ChangePartitionPCDrive(dir);
+        else
+        {
+            global_app->CreateShowDialog(cfg::strings::Main.GetString(407), cfg::strings::Main.GetString(411), { cfg::strings::Main.GetString(234) }, true);
+            return;
+        }
+        global_app->LoadMenuData(cfg::strings::Main.GetString(407), "Storage", browser->GetExplorer()->GetPresentableCwd());
+        global_app->LoadLayout(browser);
+    }
+}
@@ -89,12 +89,14 @@ namespace ui
         global_app->LoadMenuHead(cfg::strings::Main.GetString(359) + " " + Fw.display_version + "...");
         auto outnsp = sd->FullPathFor(consts::Root + "/dump/update/" + Fw.display_version + ".nsp");
         sd->DeleteFile(outnsp);
-        nsp::GenerateFrom(exp->FullPathFor(Input), outnsp, [&](u64 Done, u64 Total)
+        fs::Hasher nsphash(fs::HashType::SHA256);
+        auto ok = nsp::GenerateFrom(exp->FullPathFor(Input), outnsp, [&](u64 Done, u64 Total)
         {
             this->progressInfo->SetMaxValue((double)Total);
             this->progressInfo->SetProgress((double)Done);
             global_app->CallForRender();
-        });
+        }, &nsphash);
+        if(ok) fs::WriteHashManifest(outnsp, fs::HashType::SHA256, nsphash.Finish());
         global_app->LoadMenuData(cfg::strings::Main.GetString(43), "Settings", cfg::strings::Main.GetString(44));
         this->optsMenu->SetVisible(true);
         this->progressInfo->SetVisible(false);
@@ -120,7 +120,6 @@ namespace ui
         {
             this->dumpText->SetText(cfg::strings::Main.GetString(194));
             xmeta = outdir + "/" + hos::ContentIdAsString(meta) + ".cnmt.nca";
-            fs::CreateConcatenationFile(xmeta);
             this->ncaBar->SetVisible(true);
             dump::DecryptCopyNAX0ToNCA(&cst, meta, xmeta, [&](double Done, double Total)
             {
@@ -132,7 +131,6 @@ namespace ui
             if(hasprogram)
             {
                 xprogram = outdir + "/" + hos::ContentIdAsString(program) + ".nca";
-                fs::CreateConcatenationFile(xprogram);
                 this->ncaBar->SetVisible(true);
                 dump::DecryptCopyNAX0ToNCA(&cst, program, xprogram, [&](double Done, double Total)
                 {
@@ -145,7 +143,6 @@ namespace ui
             if(hascontrol)
             {
                 xcontrol = outdir + "/" + hos::ContentIdAsString(control) + ".nca";
-                fs::CreateConcatenationFile(xcontrol);
                 this->ncaBar->SetVisible(true);
                 dump::DecryptCopyNAX0ToNCA(&cst, control, xcontrol, [&](double Done, double Total)
                 {
@@ -158,7 +155,6 @@ namespace ui
             if(haslinfo)
             {
                 xlinfo = outdir + "/" + hos::ContentIdAsString(linfo) + ".nca";
-                fs::CreateConcatenationFile(xlinfo);
                 this->ncaBar->SetVisible(true);
                 dump::DecryptCopyNAX0ToNCA(&cst, linfo, xlinfo, [&](double Done, double Total)
                 {
@@ -171,7 +167,6 @@ namespace ui
             if(hashoff)
             {
                 xhoff = outdir + "/" + hos::ContentIdAsString(hoff) + ".nca";
-                fs::CreateConcatenationFile(xhoff);
                 this->ncaBar->SetVisible(true);
                 dump::DecryptCopyNAX0ToNCA(&cst, hoff, xhoff, [&](double Done, double Total)
                 {
@@ -184,7 +179,6 @@ namespace ui
             if(hasdata)
             {
                 xdata = outdir + "/" + hos::ContentIdAsString(data) + ".nca";
-                fs::CreateConcatenationFile(xdata);
                 this->ncaBar->SetVisible(true);
                 dump::DecryptCopyNAX0ToNCA(&cst, data, xdata, [&](double Done, double Total)
                 {
@@ -212,7 +206,6 @@ namespace ui
             this->dumpText->SetText(cfg::strings::Main.GetString(195));
             xmeta = nexp->FullPathFor("Contents/" + xmeta.substr(15));
             String txmeta = outdir + "/" + hos::ContentIdAsString(meta) + ".cnmt.nca";
-            fs::CreateConcatenationFile(txmeta);
             this->ncaBar->SetVisible(true);
             fs::CopyFileProgress(xmeta, txmeta, [&](double done, double total)
             {
@@ -226,7 +219,6 @@ namespace ui
             {
                 xprogram = nexp->FullPathFor("Contents/" + xprogram.substr(15));
                 String txprogram = outdir + "/" + hos::ContentIdAsString(program) + ".nca";
-                fs::CreateConcatenationFile(txprogram);
                 this->ncaBar->SetVisible(true);
                 fs::CopyFileProgress(xprogram, txprogram, [&](double done, double total)
                 {
@@ -241,7 +233,6 @@ namespace ui
             {
                 xcontrol = nexp->FullPathFor("Contents/" + xcontrol.substr(15));
                 String txcontrol = outdir + "/" + hos::ContentIdAsString(control) + ".nca";
-                fs::CreateConcatenationFile(txcontrol);
                 this->ncaBar->SetVisible(true);
                 fs::CopyFileProgress(xcontrol, txcontrol, [&](double done, double total)
                 {
@@ -256,7 +247,6 @@ namespace ui
             {
                 xlinfo = nexp->FullPathFor("Contents/" + xlinfo.substr(15));
                 String txlinfo = outdir + "/" + hos::ContentIdAsString(linfo) + ".nca";
-                fs::CreateConcatenationFile(txlinfo);
                 this->ncaBar->SetVisible(true);
                 fs::CopyFileProgress(xlinfo, txlinfo, [&](double done, double total)
                 {
@@ -271,7 +261,6 @@ namespace ui
             {
                 xhoff = nexp->FullPathFor("Contents/" + xhoff.substr(15));
                 String txhoff = outdir + "/" + hos::ContentIdAsString(hoff) + ".nca";
-                fs::CreateConcatenationFile(txhoff);
                 this->ncaBar->SetVisible(true);
                 fs::CopyFileProgress(xhoff, txhoff, [&](double done, double total)
                 {
@@ -286,7 +275,6 @@ namespace ui
             {
                 xdata = nexp->FullPathFor("Contents/" + xdata.substr(15));
                 String txdata = outdir + "/" + hos::ContentIdAsString(data) + ".nca";
-                fs::CreateConcatenationFile(txdata);
                 this->ncaBar->SetVisible(true);
                 fs::CopyFileProgress(xdata, txdata, [&](double done, double total)
                 {
@@ -299,15 +287,16 @@ namespace ui
             }
         }
         String fout = "sdmc:/" + consts::Root + "/dump/title/" + fappid + ".nsp";
-        fs::CreateConcatenationFile(fout);
         this->ncaBar->SetVisible(true);
         this->dumpText->SetText(cfg::strings::Main.GetString(196));
+        fs::Hasher nsphash(fs::HashType::SHA256);
         ok = nsp::GenerateFrom(outdir, fout, [&](u64 done, u64 total)
         {
             this->ncaBar->SetMaxValue((double)total);
             this->ncaBar->SetProgress((double)done);
             global_app->CallForRender();
-        });
+        }, &nsphash);
+        if(ok) fs::WriteHashManifest(fout, fs::HashType::SHA256, nsphash.Finish());
         hos::UnlockAutoSleep();
         fs::DeleteDirectory("sdmc:/" + consts::Root + "/dump/temp");
         fs::DeleteDirectory(outdir);
@@ -24,6 +24,13 @@
 
 namespace usb
 {
+    static std::recursive_mutex cmdlock;
+
+    std::recursive_mutex &GetCommandLock()
+    {
+        return cmdlock;
+    }
+
     InCommandBlock::InCommandBlock(CommandId CmdId)
     {
         base.position = 0;
@@ -63,6 +63,7 @@ public class MainApplication extends Application
     public Scene scene;
     
     public RandomAccessFile readfile = null;
+    public String readpath = null;
     public RandomAccessFile writefile = null;
 
     public USBInterface usbInterface = null;
@@ -292,6 +293,7 @@ public class MainApplication extends Application
                                 {
                                     if(readfile != null) readfile.close();
                                     readfile = new RandomAccessFile(path, "rw");
+                                    readpath = path;
                                 }
                                 else
                                 {
@@ -310,7 +312,7 @@ public class MainApplication extends Application
                                 long size = c.read64();
                                 try
                                 {
-                                    if(readfile != null)
+                                    if((readfile != null) && path.equals(readpath))
                                     {
                                         byte[] block = new byte[(int)size];
                                         readfile.seek(offset);
@@ -374,6 +376,7 @@ public class MainApplication extends Application
                                     {
                                         readfile.close();
                                         readfile = null;
+                                        readpath = null;
                                     }
                                 }
                                 else
@@ -430,8 +433,11 @@ public class MainApplication extends Application
                                     try
                                     {
                                         File p = new File(path);
-                                        p.renameTo(new File(p.getParent(), newpath));
-                                        c.respondEmpty();
+                                        // Moves send a full path, renames from the browser only the new name
+                                        File np = new File(newpath);
+                                        if(!np.isAbsolute()) np = new File(p.getParent(), newpath);
+                                        if(np.exists() || !p.renameTo(np)) c.respondFailure(0xDEAD);
+                                        else c.respondEmpty();
                                     }
                                     catch(Exception e)
                                     {